@@ -67,9 +67,11 @@
     }                   \
     while (0)
 
+#include <atomic>
 #include <limits.h>
 #include <setjmp.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #define SW_FT_UINT_MAX UINT_MAX
 #define SW_FT_INT_MAX INT_MAX
@@ -101,9 +103,15 @@ typedef ptrdiff_t SW_FT_PtrDist;
 #define SW_FT_THROW(e) SW_FT_ERR_CAT(ErrRaster_, e)
 
 /* The size in bytes of the render pool used by the scan-line converter  */
-/* to do all of its work.                                                */
+/* to do all of its work.  The pool is kept per thread and doubled up to */
+/* SW_FT_RENDER_POOL_MAX when an outline does not fit in it, outlines    */
+/* are split into bands only when the pool can not grow anymore.         */
 #define SW_FT_RENDER_POOL_SIZE 16384L
 
+#ifndef SW_FT_RENDER_POOL_MAX
+#define SW_FT_RENDER_POOL_MAX (4L * 1024L * 1024L)
+#endif
+
 typedef int (*SW_FT_Outline_MoveToFunc)(const SW_FT_Vector* to, void* user);
 
 #define SW_FT_Outline_MoveTo_Func SW_FT_Outline_MoveToFunc
@@ -159,7 +167,9 @@ typedef struct SW_FT_Outline_Funcs_ {
 #undef RAS_VAR
 #undef RAS_VAR_
 
-#ifndef SW_FT_STATIC_RASTER
+/* the worker is always passed explicitly: every render call keeps its */
+/* state (cells, bands, jump buffer) on its own stack, so several threads */
+/* can rasterize at the same time.                                        */
 
 #define RAS_ARG gray_PWorker worker
 #define RAS_ARG_ gray_PWorker worker,
@@ -167,15 +177,6 @@ typedef struct SW_FT_Outline_Funcs_ {
 #define RAS_VAR worker
 #define RAS_VAR_ worker,
 
-#else /* SW_FT_STATIC_RASTER */
-
-#define RAS_ARG  /* empty */
-#define RAS_ARG_ /* empty */
-#define RAS_VAR  /* empty */
-#define RAS_VAR_ /* empty */
-
-#endif /* SW_FT_STATIC_RASTER */
-
 /* must be at least 6 bits! */
 #define PIXEL_BITS 8
 
@@ -317,14 +318,21 @@ typedef struct gray_TWorker_ {
     int           bound_bottom;
 
     SW_FT_Span gray_spans[SW_FT_MAX_GRAY_SPANS];
-    int        num_gray_spans;
+    SW_FT_Span* spans;   /* gray_spans or table of span_buffer */
+    int         max_spans;
+    int         num_gray_spans;
 
     SW_FT_Raster_Span_Func render_span;
+    SW_FT_SpanBufferFunc   span_buffer;
     void*                  render_span_data;
 
     int band_size;
     int band_shoot;
 
+    int num_bands;   /* passes over the outline, for statistics */
+    int num_splits;
+    int num_grows;
+
     ft_jmp_buf jump_buffer;
 
     void* buffer;
@@ -339,11 +347,47 @@ typedef struct gray_TWorker_ {
 #pragma warning(pop)
 #endif
 
-#ifndef SW_FT_STATIC_RASTER
 #define ras (*worker)
-#else
-static gray_TWorker ras;
-#endif
+
+static std::atomic<long> gray_stat_renders{0};
+static std::atomic<long> gray_stat_bands{0};
+static std::atomic<long> gray_stat_band_splits{0};
+static std::atomic<long> gray_stat_pool_grows{0};
+static std::atomic<long> gray_stat_pool_bytes{0};
+
+/* the cell pool of calling thread, it only grows and is freed when the */
+/* thread exits                                                         */
+typedef struct gray_TPool_ {
+    void* buffer;
+    long  size;
+
+    ~gray_TPool_()
+    {
+        free(buffer);
+        gray_stat_pool_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+} gray_TPool;
+
+static thread_local gray_TPool gray_pool = {NULL, 0};
+
+static int gray_pool_grow(long size)
+{
+    void* buffer;
+
+    if (size <= gray_pool.size) return 1;
+    if (size > SW_FT_RENDER_POOL_MAX) return 0;
+
+    /* old content is not needed, cells are rebuilt for every pass */
+    buffer = malloc(size);
+    if (!buffer) return 0;
+
+    free(gray_pool.buffer);
+    gray_stat_pool_bytes.fetch_add(size - gray_pool.size, std::memory_order_relaxed);
+    gray_pool.buffer = buffer;
+    gray_pool.size = size;
+    return 1;
+}
 
 typedef struct gray_TRaster_ {
     void* memory;
@@ -885,20 +929,52 @@ static int gray_cubic_to(const SW_FT_Vector* control1,
     return 0;
 }
 
-static void gray_hline(RAS_ARG_ TCoord x, TCoord y, TPos area, TCoord acount)
+/* hand the collected spans to the client; with a span buffer they are */
+/* already in place and only a new table is fetched                     */
+static void gray_flush_spans(RAS_ARG_ int more)
 {
-    int coverage;
-
-    /* compute the coverage line's coverage, depending on the    */
-    /* outline fill rule                                         */
-    /*                                                           */
-    /* the coverage percentage is area/(PIXEL_BITS*PIXEL_BITS*2) */
-    /*                                                           */
-    coverage = (int)(area >> (PIXEL_BITS * 2 + 1 - 8));
+    if (ras.span_buffer) {
+        int capacity = more ? SW_FT_MAX_GRAY_SPANS : 0;
+
+        ras.spans = ras.span_buffer(ras.num_gray_spans, &capacity,
+                                    ras.render_span_data);
+        ras.max_spans = capacity;
+        if (!ras.spans || capacity <= 0) {
+            ras.span_buffer = NULL;
+            ras.spans = ras.gray_spans;
+            ras.max_spans = SW_FT_MAX_GRAY_SPANS;
+        }
+    } else if (ras.render_span && ras.num_gray_spans > 0) {
+        ras.render_span(ras.num_gray_spans, ras.spans, ras.render_span_data);
+
+#ifdef DEBUG_GRAYS
+
+        if (1) {
+            int         n;
+            SW_FT_Span* span = ras.spans;
+
+            fprintf(stderr, "count = %3d ", ras.num_gray_spans);
+            for (n = 0; n < ras.num_gray_spans; n++, span++)
+                fprintf(stderr, "[%d , %d..%d] : %d ", span->y, span->x,
+                        span->x + span->len - 1, span->coverage);
+            fprintf(stderr, "\n");
+        }
+
+#endif /* DEBUG_GRAYS */
+    }
+    ras.num_gray_spans = 0;
+}
+
+/* coverage of an area, depending on the outline fill rule; the */
+/* coverage percentage is area/(PIXEL_BITS*PIXEL_BITS*2)         */
+static inline int gray_coverage(TPos area, int even_odd)
+{
+    int coverage = (int)(area >> (PIXEL_BITS * 2 + 1 - 8));
+
     /* use range 0..256 */
     if (coverage < 0) coverage = -coverage;
 
-    if (ras.outline.flags & SW_FT_OUTLINE_EVEN_ODD_FILL) {
+    if (even_odd) {
         coverage &= 511;
 
         if (coverage > 256)
@@ -909,107 +985,112 @@ static void gray_hline(RAS_ARG_ TCoord x, TCoord y, TPos area, TCoord acount)
         /* normal non-zero winding rule */
         if (coverage >= 256) coverage = 255;
     }
+    return coverage;
+}
 
-    y += (TCoord)ras.min_ey;
-    x += (TCoord)ras.min_ex;
+/* append a span of one row, spans of a row come sorted by x so the */
+/* bounding box is updated once per row by the caller               */
+static inline void gray_row_span(RAS_ARG_ TCoord x, TCoord y, TCoord acount,
+                                 int coverage)
+{
+    SW_FT_Span* span;
+    int         count;
 
     /* SW_FT_Span.x is a 16-bit short, so limit our coordinates appropriately */
     if (x >= 32767) x = 32767;
 
-    /* SW_FT_Span.y is an integer, so limit our coordinates appropriately */
-    if (y >= SW_FT_INT_MAX) y = SW_FT_INT_MAX;
-
-    if (coverage) {
-        SW_FT_Span* span;
-        int         count;
-
-        // update bounding box.
-        if (x < ras.bound_left) ras.bound_left = x;
-        if (y < ras.bound_top) ras.bound_top = y;
-        if (y > ras.bound_bottom) ras.bound_bottom = y;
-        if (x + acount > ras.bound_right) ras.bound_right = x + acount;
-
-        /* see whether we can add this span to the current list */
-        count = ras.num_gray_spans;
-        span = ras.gray_spans + count - 1;
-        if (count > 0 && span->y == y && (int)span->x + span->len == (int)x &&
-            span->coverage == coverage) {
-            span->len = (unsigned short)(span->len + acount);
-            return;
-        }
-
-        if (count >= SW_FT_MAX_GRAY_SPANS) {
-            if (ras.render_span && count > 0)
-                ras.render_span(count, ras.gray_spans, ras.render_span_data);
-
-#ifdef DEBUG_GRAYS
-
-            if (1) {
-                int n;
-
-                fprintf(stderr, "count = %3d ", count);
-                span = ras.gray_spans;
-                for (n = 0; n < count; n++, span++)
-                    fprintf(stderr, "[%d , %d..%d] : %d ", span->y, span->x,
-                            span->x + span->len - 1, span->coverage);
-                fprintf(stderr, "\n");
-            }
-
-#endif /* DEBUG_GRAYS */
-
-            ras.num_gray_spans = 0;
+    count = ras.num_gray_spans;
+    span = ras.spans + count - 1;
+    if (count > 0 && span->y == y && (int)span->x + span->len == (int)x &&
+        span->coverage == coverage) {
+        span->len = (unsigned short)(span->len + acount);
+        return;
+    }
 
-            span = ras.gray_spans;
-        } else
-            span++;
+    if (count >= ras.max_spans) {
+        gray_flush_spans(RAS_VAR_ 1);
+        span = ras.spans;
+    } else
+        span++;
 
-        /* add a gray span to the current list */
-        span->x = (short)x;
-        span->y = (short)y;
-        span->len = (unsigned short)acount;
-        span->coverage = (unsigned char)coverage;
+    span->x = (short)x;
+    span->y = (short)y;
+    span->len = (unsigned short)acount;
+    span->coverage = (unsigned char)coverage;
 
-        ras.num_gray_spans++;
-    }
+    ras.num_gray_spans++;
 }
 
 static void gray_sweep(RAS_ARG)
 {
     int yindex;
+    int even_odd = (ras.outline.flags & SW_FT_OUTLINE_EVEN_ODD_FILL) != 0;
 
     if (ras.num_cells == 0) return;
 
-    ras.num_gray_spans = 0;
-
     for (yindex = 0; yindex < ras.ycount; yindex++) {
         PCell  cell = ras.ycells[yindex];
         TCoord cover = 0;
         TCoord x = 0;
+        TCoord y = yindex + (TCoord)ras.min_ey;
+        TCoord left = 32767, right = INT_MIN;
+        int    coverage;
+
+        /* SW_FT_Span.y is an integer, so limit our coordinates appropriately */
+        if (y >= SW_FT_INT_MAX) y = SW_FT_INT_MAX;
 
         for (; cell != NULL; cell = cell->next) {
             TPos area;
 
-            if (cell->x > x && cover != 0)
-                gray_hline(RAS_VAR_ x, yindex, cover * (ONE_PIXEL * 2),
-                           cell->x - x);
+            if (cell->x > x && cover != 0) {
+                coverage = gray_coverage(cover * (ONE_PIXEL * 2), even_odd);
+                if (coverage) {
+                    if (left > x) left = x;
+                    right = cell->x;
+                    gray_row_span(RAS_VAR_ x + ras.min_ex, y, cell->x - x,
+                                  coverage);
+                }
+            }
 
             cover += cell->cover;
             area = cover * (ONE_PIXEL * 2) - cell->area;
 
-            if (area != 0 && cell->x >= 0)
-                gray_hline(RAS_VAR_ cell->x, yindex, area, 1);
+            if (area != 0 && cell->x >= 0) {
+                coverage = gray_coverage(area, even_odd);
+                if (coverage) {
+                    if (left > cell->x) left = cell->x;
+                    right = cell->x + 1;
+                    gray_row_span(RAS_VAR_ cell->x + ras.min_ex, y, 1, coverage);
+                }
+            }
 
             x = cell->x + 1;
         }
 
-        if (cover != 0)
-            gray_hline(RAS_VAR_ x, yindex, cover * (ONE_PIXEL * 2),
-                       ras.count_ex - x);
+        if (cover != 0) {
+            coverage = gray_coverage(cover * (ONE_PIXEL * 2), even_odd);
+            if (coverage) {
+                if (left > x) left = x;
+                right = ras.count_ex;
+                gray_row_span(RAS_VAR_ x + ras.min_ex, y, ras.count_ex - x,
+                              coverage);
+            }
+        }
+
+        /* update bounding box. */
+        if (right != INT_MIN) {
+            left += ras.min_ex;
+            right += ras.min_ex;
+            if (left > 32767) left = 32767;
+            if (left < ras.bound_left) ras.bound_left = (int)left;
+            if (right > ras.bound_right) ras.bound_right = (int)right;
+            if (y < ras.bound_top) ras.bound_top = (int)y;
+            if (y > ras.bound_bottom) ras.bound_bottom = (int)y;
+        }
     }
 
-    if (ras.render_span && ras.num_gray_spans > 0)
-        ras.render_span(ras.num_gray_spans, ras.gray_spans,
-                        ras.render_span_data);
+    /* a span buffer keeps collecting spans of the next bands */
+    if (!ras.span_buffer) gray_flush_spans(RAS_VAR_ 0);
 }
 
 /*************************************************************************/
@@ -1335,6 +1416,7 @@ static int gray_convert_glyph(RAS_ARG)
             ras.max_ey = band->max;
             ras.count_ey = band->max - band->min;
 
+            ras.num_bands++;
             error = gray_convert_glyph_inner(RAS_VAR);
 
             if (!error) {
@@ -1345,7 +1427,16 @@ static int gray_convert_glyph(RAS_ARG)
                 return 1;
 
         ReduceBands:
-            /* render pool overflow; we will reduce the render band by half */
+            /* render pool overflow; grow the pool and retry the same band */
+            if (gray_pool_grow(ras.buffer_size * 2)) {
+                ras.buffer = gray_pool.buffer;
+                ras.buffer_size = gray_pool.size;
+                ras.num_grows++;
+                continue;
+            }
+
+            /* pool is at its limit; we will reduce the render band by half */
+            ras.num_splits++;
             bottom = band->min;
             top = band->max;
             middle = bottom + ((top - bottom) >> 1);
@@ -1380,9 +1471,8 @@ static int gray_raster_render(gray_PRaster               raster,
 
     gray_TWorker worker[1];
 
-    TCell buffer[SW_FT_RENDER_POOL_SIZE / sizeof(TCell)];
-    long  buffer_size = sizeof(buffer);
-    int   band_size = (int)(buffer_size / (long)(sizeof(TCell) * 8));
+    long buffer_size;
+    int  band_size;
 
     if (!outline) return SW_FT_THROW(Invalid_Outline);
 
@@ -1408,41 +1498,83 @@ static int gray_raster_render(gray_PRaster               raster,
         ras.clip_box.yMax = 32767L;
     }
 
-    gray_init_cells(RAS_VAR_ buffer, buffer_size);
+    if (!gray_pool_grow(SW_FT_RENDER_POOL_SIZE)) return SW_FT_THROW(Memory_Overflow);
+
+    /* while the pool can grow, try the whole outline in a single band */
+    buffer_size = gray_pool.size;
+    if (buffer_size < SW_FT_RENDER_POOL_MAX)
+        band_size = 32767;
+    else
+        band_size = (int)(buffer_size / (long)(sizeof(TCell) * 8));
+
+    gray_init_cells(RAS_VAR_ gray_pool.buffer, buffer_size);
 
     ras.outline = *outline;
     ras.num_cells = 0;
     ras.invalid = 1;
     ras.band_size = band_size;
     ras.num_gray_spans = 0;
+    ras.num_bands = 0;
+    ras.num_splits = 0;
+    ras.num_grows = 0;
 
     ras.render_span = (SW_FT_Raster_Span_Func)params->gray_spans;
     ras.render_span_data = params->user;
+    ras.span_buffer = params->span_buffer;
+    ras.spans = ras.gray_spans;
+    ras.max_spans = SW_FT_MAX_GRAY_SPANS;
+    if (ras.span_buffer) gray_flush_spans(RAS_VAR_ 1);
 
     gray_convert_glyph(RAS_VAR);
+    if (ras.span_buffer) gray_flush_spans(RAS_VAR_ 0);
     params->bbox_cb(ras.bound_left, ras.bound_top,
                     ras.bound_right - ras.bound_left,
                     ras.bound_bottom - ras.bound_top + 1, params->user);
+
+    if (ras.num_bands) {
+        gray_stat_renders.fetch_add(1, std::memory_order_relaxed);
+        gray_stat_bands.fetch_add(ras.num_bands, std::memory_order_relaxed);
+    }
+    if (ras.num_splits)
+        gray_stat_band_splits.fetch_add(ras.num_splits, std::memory_order_relaxed);
+    if (ras.num_grows)
+        gray_stat_pool_grows.fetch_add(ras.num_grows, std::memory_order_relaxed);
     return 1;
 }
 
-/**** RASTER OBJECT CREATION: In stand-alone mode, we simply use *****/
-/****                         a static object.                   *****/
+void sw_ft_grays_raster_stats(SW_FT_Raster_Stats* stats, int reset)
+{
+    if (reset) {
+        stats->renders = gray_stat_renders.exchange(0);
+        stats->bands = gray_stat_bands.exchange(0);
+        stats->band_splits = gray_stat_band_splits.exchange(0);
+        stats->pool_grows = gray_stat_pool_grows.exchange(0);
+    } else {
+        stats->renders = gray_stat_renders.load();
+        stats->bands = gray_stat_bands.load();
+        stats->band_splits = gray_stat_band_splits.load();
+        stats->pool_grows = gray_stat_pool_grows.load();
+    }
+    /* memory held by pools is not a counter, it is never reset */
+    stats->pool_bytes = gray_stat_pool_bytes.load();
+}
+
+/**** RASTER OBJECT CREATION: each caller gets its own object, so *****/
+/****                         no raster state is shared.          *****/
 
 static int gray_raster_new(SW_FT_Raster* araster)
 {
-    static gray_TRaster the_raster;
+    gray_PRaster raster = (gray_PRaster)calloc(1, sizeof(gray_TRaster));
 
-    *araster = (SW_FT_Raster)&the_raster;
-    SW_FT_MEM_ZERO(&the_raster, sizeof(the_raster));
+    if (!raster) return SW_FT_THROW(Memory_Overflow);
 
+    *araster = (SW_FT_Raster)raster;
     return 0;
 }
 
 static void gray_raster_done(SW_FT_Raster raster)
 {
-    /* nothing */
-    SW_FT_UNUSED(raster);
+    free(raster);
 }
 
 static void gray_raster_reset(SW_FT_Raster raster, char* pool_base,
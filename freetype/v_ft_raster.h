@@ -292,6 +292,36 @@ typedef struct  SW_FT_Outline_
 #define SW_FT_Raster_Span_Func  SW_FT_SpanFunc
 
 
+  /*************************************************************************/
+  /*                                                                       */
+  /* <FuncType>                                                            */
+  /*    SW_FT_SpanBufferFunc                                               */
+  /*                                                                       */
+  /* <Description>                                                         */
+  /*    A function used by the gray raster to write spans straight to the  */
+  /*    client's storage instead of passing them to @SW_FT_SpanFunc.       */
+  /*                                                                       */
+  /* <Input>                                                               */
+  /*    count    :: The number of spans written to the table returned by   */
+  /*                the previous call, 0 for the first call.  They must be */
+  /*                kept.                                                  */
+  /*                                                                       */
+  /*    capacity :: The number of spans wanted in the next table, the      */
+  /*                client sets it to the real size of the returned table. */
+  /*                It is 0 on the last call of a render.                  */
+  /*                                                                       */
+  /*    user     :: User-supplied data that is passed to the callback.     */
+  /*                                                                       */
+  /* <Return>                                                              */
+  /*    The table for the next spans.  If it is NULL or `capacity' is 0,   */
+  /*    the raster passes the rest of spans to @SW_FT_SpanFunc.            */
+  /*                                                                       */
+  typedef SW_FT_Span*
+  (*SW_FT_SpanBufferFunc)( int    count,
+                           int*   capacity,
+                           void*  user );
+
+
 
   /*************************************************************************/
   /*                                                                       */
@@ -364,6 +394,9 @@ typedef struct  SW_FT_Outline_
   /*                                                                       */
   /*    gray_spans  :: The gray span drawing callback.                     */
   /*                                                                       */
+  /*    span_buffer :: Optional, when set spans are written to tables it   */
+  /*                   returns and `gray_spans' is not called.             */
+  /*                                                                       */
   /*    black_spans :: The black span drawing callback.  UNIMPLEMENTED!    */
   /*                                                                       */
   /*    bit_test    :: The bit test callback.  UNIMPLEMENTED!              */
@@ -400,6 +433,7 @@ typedef struct  SW_FT_Outline_
     const void*             source;
     int                     flags;
     SW_FT_SpanFunc          gray_spans;
+    SW_FT_SpanBufferFunc    span_buffer;
     SW_FT_BboxFunc          bbox_cb;
     void*                   user;
     SW_FT_BBox              clip_box;
@@ -610,4 +644,46 @@ SW_FT_Outline_Get_CBox( const SW_FT_Outline*  outline,
 
 extern const SW_FT_Raster_Funcs   sw_ft_grays_raster;
 
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* <Struct>                                                              */
+  /*    SW_FT_Raster_Stats                                                 */
+  /*                                                                       */
+  /* <Description>                                                         */
+  /*    Counters of the gray raster, summed over all threads.              */
+  /*                                                                       */
+  /* <Fields>                                                              */
+  /*    renders     :: Outlines converted, outlines outside of the clip    */
+  /*                   box are not counted.                                */
+  /*    bands       :: Passes over outlines, every band beyond the first   */
+  /*                   one of an outline re-decomposes the whole outline.  */
+  /*    band_splits :: Bands split in two because the cell pool was full   */
+  /*                   and could not grow anymore.                         */
+  /*    pool_grows  :: Times the cell pool of a thread was enlarged.       */
+  /*    pool_bytes  :: Memory currently held by cell pools of all threads. */
+  /*                                                                       */
+  typedef struct  SW_FT_Raster_Stats_
+  {
+    long  renders;
+    long  bands;
+    long  band_splits;
+    long  pool_grows;
+    long  pool_bytes;
+
+  } SW_FT_Raster_Stats;
+
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* <Function>                                                            */
+  /*    sw_ft_grays_raster_stats                                           */
+  /*                                                                       */
+  /* <Description>                                                         */
+  /*    Read the gray raster counters, and zero them if `reset' is set.    */
+  /*                                                                       */
+  void
+  sw_ft_grays_raster_stats( SW_FT_Raster_Stats*  stats,
+                            int                  reset );
+
 #endif // V_FT_IMG_H
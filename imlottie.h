@@ -23,10 +23,19 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include <cassert>
 
 #include "imgui.h"
@@ -47,9 +56,13 @@
 namespace imlottie { 
     class Animation;
     std::shared_ptr<imlottie::Animation> animationLoad(const char *path);
+    bool animationPrepare(const std::shared_ptr<imlottie::Animation> &anim);
     uint16_t animationTotalFrame(const std::shared_ptr<imlottie::Animation> &anim);
     double animationDuration(const std::shared_ptr<imlottie::Animation> &anim);
     void animationRenderSync(const std::shared_ptr<imlottie::Animation> &anim, int nextFrameIndex, uint32_t *data, int width, int height, int row_pitch);
+    // threads which rasterize shapes of one frame, 1 (default) rasterize on
+    // render workers only, 0 means hardware concurrency. Call it before ImLottie::init()
+    void configureRasterThreads(unsigned threads);
 }
 
 namespace ImLottie {
@@ -74,6 +87,156 @@ struct ReadyFrame {
 #endif
 };
 
+// Counters of frame buffers pool
+struct LottieFramePoolStats {
+    size_t buffersLive = 0;     // borrowed by frames and not returned yet
+    size_t bytesLive = 0;
+    size_t buffersPooled = 0;   // returned and wait for next borrow
+    size_t bytesPooled = 0;
+    size_t highWaterBytes = 0;  // max of live and pooled bytes at same time
+};
+
+// Pool of memory for frames. Render thread borrow buffer for every prerendered frame
+// and main thread return it after frame was uploaded to texture, so frames not
+// allocate memory on every render. Buffers grouped by size classes, class is size
+// rounded up to PAGE_SIZE, so animations with near sizes share same buffers
+struct LottieFramePool {
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    std::vector<uint8_t> acquire(size_t size) {
+        const size_t sizeClass = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+        std::vector<uint8_t> buffer;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = freeBuffers.find(sizeClass);
+            if (it != freeBuffers.end() && !it->second.empty()) {
+                buffer = std::move(it->second.back());
+                it->second.pop_back();
+                stats.buffersPooled--;
+                stats.bytesPooled -= sizeClass * PAGE_SIZE;
+            }
+        }
+
+        if (buffer.capacity() == 0) {
+            buffer.reserve(sizeClass * PAGE_SIZE);
+        }
+
+        // buffers from pool usually have same size, so it not touch memory
+        buffer.resize(size);
+
+        // remember which buffers were borrowed and their class, release() files
+        // them back by this tag and not by capacity which allocator may round
+        std::lock_guard<std::mutex> lock(mutex);
+        borrowed[buffer.data()] = sizeClass;
+        stats.buffersLive++;
+        stats.bytesLive += sizeClass * PAGE_SIZE;
+        stats.highWaterBytes = std::max<size_t>(stats.highWaterBytes, stats.bytesLive + stats.bytesPooled);
+        return buffer;
+    }
+
+    // buffer become empty, buffers which were not borrowed from pool just freed
+    void release(std::vector<uint8_t> &buffer) {
+        std::vector<uint8_t> foreign;
+        if (buffer.capacity() != 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = borrowed.find(buffer.data());
+            if (it != borrowed.end()) {
+                const size_t sizeClass = it->second;
+                borrowed.erase(it);
+                stats.buffersLive--;
+                stats.bytesLive -= sizeClass * PAGE_SIZE;
+                stats.buffersPooled++;
+                stats.bytesPooled += sizeClass * PAGE_SIZE;
+                freeBuffers[sizeClass].push_back(std::move(buffer));
+            } else {
+                foreign.swap(buffer);
+            }
+        }
+        buffer = {};
+    }
+
+    // free pooled buffers until pool keep no more than maxPooledBytes
+    void trim(size_t maxPooledBytes = 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = freeBuffers.begin(); it != freeBuffers.end() && stats.bytesPooled > maxPooledBytes;) {
+            auto &buffers = it->second;
+            while (!buffers.empty() && stats.bytesPooled > maxPooledBytes) {
+                buffers.pop_back();
+                stats.buffersPooled--;
+                stats.bytesPooled -= it->first * PAGE_SIZE;
+            }
+            it = buffers.empty() ? freeBuffers.erase(it) : std::next(it);
+        }
+    }
+
+    LottieFramePoolStats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<size_t, std::vector<std::vector<uint8_t>>> freeBuffers;
+    std::unordered_map<const uint8_t *, size_t> borrowed;
+    LottieFramePoolStats stats;
+};
+
+// Single slot for newest ready frame of animation. Render thread post frames here,
+// main thread take them on upload, and frame which was not taken before next one
+// is obsolete, so it replaced and never uploaded. Mailbox owns two frames which
+// move between render thread, slot and main thread, so posting not allocate
+struct LottieMailbox {
+    // render thread: returns empty frame to fill, when main thread upload other
+    // frame now, it takes back newest frame from slot and sets obsolete flag
+    ReadyFrame *acquire(bool &obsolete) {
+        obsolete = false;
+        if (own) {
+            ReadyFrame *frame = own;
+            own = nullptr;
+            return frame;
+        }
+
+        for (;;) {
+            if (ReadyFrame *frame = spare.exchange(nullptr, std::memory_order_acq_rel)) {
+                return frame;
+            }
+            // main thread take frame from slot only after it recycle previous one
+            if (ReadyFrame *frame = slot.exchange(nullptr, std::memory_order_acq_rel)) {
+                obsolete = true;
+                return frame;
+            }
+        }
+    }
+
+    // render thread: returns replaced frame, it is obsolete and must be given back with keep()
+    ReadyFrame *post(ReadyFrame *frame) { return slot.exchange(frame, std::memory_order_acq_rel); }
+
+    // render thread: return frame which memory was released to pool
+    void keep(ReadyFrame *frame) {
+        frame->pid = BAD_PICTUREID;
+        if (!own) {
+            own = frame;
+        } else {
+            spare.store(frame, std::memory_order_release);
+        }
+    }
+
+    // main thread: returns newest frame or nullptr, give it back with recycle() after upload
+    ReadyFrame *take() { return slot.exchange(nullptr, std::memory_order_acq_rel); }
+
+    // main thread: return uploaded frame which memory was released to pool
+    void recycle(ReadyFrame *frame) {
+        frame->pid = BAD_PICTUREID;
+        spare.store(frame, std::memory_order_release);
+    }
+
+private:
+    ReadyFrame frames[2];
+    ReadyFrame *own = &frames[0];  // used by render thread only
+    std::atomic<ReadyFrame *> spare{&frames[1]};
+    std::atomic<ReadyFrame *> slot{nullptr};
+};
+
 class LottieAnimationRenderer;
 namespace detail {
     LottieAnimationRenderer *g_lottieRenderer = nullptr;
@@ -110,6 +273,9 @@ struct LottieAnim {
     struct {
         uint32_t duration_ms = 0;
         uint32_t last_ms = 0;
+        // time when render thread should call render() again, valid while scheduled
+        uint32_t next_ms = 0;
+        bool scheduled = false;
     } timeline;
 
     struct {
@@ -121,11 +287,19 @@ struct LottieAnim {
     bool loop = false;
     bool play = false;
     bool renderonce = false;
+    // animation was not submitted by ImGui last frames, so nobody see it
+    bool suspended = false;
+    // model is parsed by load pool, animation is not rendered until it done
+    bool loaded = false;
+    // id of load pool request, unlike model pointer it is never reused
+    uint64_t loadId = 0;
 
     int maxPrerenderedFrames = DEFAULT_PRERENDERED_FRAMES;
     std::string lottiePath;
 
     std::shared_ptr<imlottie::Animation> anim;
+    // memory for frames borrowed from this pool, when it set
+    LottieFramePool *framePool = nullptr;
     // we need save future frames, because are can have
     // different time for render, thread render it on loop
     std::queue<NextFrame> prerenderedFrames;
@@ -137,6 +311,9 @@ struct LottieAnim {
     bool currentFrameRendering = true;
 #endif
 
+    // newest ready frame which wait for upload to texture
+    std::unique_ptr<LottieMailbox> mailbox = std::make_unique<LottieMailbox>();
+
     // Grabs the current frame and stores it in the "f" parameter
     bool grabCurrentFrame(ReadyFrame &f) {
         if (currentFrame.pid == BAD_PICTUREID) {
@@ -147,6 +324,27 @@ struct LottieAnim {
         return true;
     }
 
+    // move current frame to mailbox, returns false when mailbox had frame which
+    // was not uploaded yet, it is obsolete now and its memory returned to pool
+    bool postCurrentFrame() {
+        if (currentFrame.pid == BAD_PICTUREID) {
+            return true;
+        }
+
+        bool obsolete = false;
+        ReadyFrame *frame = mailbox->acquire(obsolete);
+        releaseFrameData(frame->data);
+        std::swap(*frame, currentFrame);
+        currentFrame.pid = BAD_PICTUREID;
+
+        if (ReadyFrame *replaced = mailbox->post(frame)) {
+            releaseFrameData(replaced->data);
+            mailbox->keep(replaced);
+            obsolete = true;
+        }
+        return !obsolete;
+    }
+
     // Returns a hash code based on the properties of the Lottie animation
     static ImGuiID getPropsHash(const char *lottie, const int canvasWidth, const int canvasHeight, bool loop, int rate) {
         char hash[512];
@@ -184,9 +382,37 @@ struct LottieAnim {
 
         return true;
     }
+    // stop render hidden animation, prerendered frames will be stale after resume
+    void suspend() {
+        suspended = true;
+        while (!prerenderedFrames.empty()) {
+            releaseFrameData(prerenderedFrames.front().data);
+            prerenderedFrames.pop();
+        }
+    }
+
+    // move timeline to position where animation would be if it was not suspended
+    void resume(uint32_t curTime) {
+        if (!suspended)
+            return;
+
+        suspended = false;
+        renderonce = true;
+        if (!play || timeline.duration_ms == 0 || frame.total == 0)
+            return;
+
+        const uint32_t frameDiff = (curTime - timeline.last_ms) / timeline.duration_ms;
+        timeline.last_ms += frameDiff * timeline.duration_ms;
+        if (loop) {
+            frame.current = (uint16_t)((frame.current + frameDiff) % frame.total);
+        } else {
+            frame.current = (uint16_t)std::min<uint32_t>(frame.current + frameDiff, frame.total);
+        }
+    }
+
 #ifdef IMLOTTIE_SIMPLE_IMPLEMENTATION
     bool updateCurtimeFrame(uint32_t curTime) {
-        if (pid == BAD_PICTUREID || !(play || renderonce))
+        if (pid == BAD_PICTUREID || suspended || !loaded || !(play || renderonce))
             return false;
 
         renderonce = false;
@@ -202,7 +428,14 @@ struct LottieAnim {
                 frame.current %= frame.total;
             }
             size_t bufferSize = canvas.width * canvas.height * LOTTIE_SURFACE_FMT_BPP;
-            currentFrame.data.resize(bufferSize);
+            if (currentFrame.data.size() != bufferSize) {
+                releaseFrameData(currentFrame.data);
+                if (framePool) {
+                    currentFrame.data = framePool->acquire(bufferSize);
+                } else {
+                    currentFrame.data.resize(bufferSize);
+                }
+            }
             imlottie::animationRenderSync(anim, frame.current, (uint32_t*)currentFrame.data.data(), canvas.width, canvas.height, canvas.width * LOTTIE_SURFACE_FMT_BPP);
             currentFrameRendering = false;
             return true;
@@ -212,7 +445,7 @@ struct LottieAnim {
 #endif
 
     bool render(uint32_t curTime) {
-        if (pid == BAD_PICTUREID || !(play || renderonce))
+        if (pid == BAD_PICTUREID || suspended || !loaded || !(play || renderonce))
             return false;
 
         renderonce = false;
@@ -229,6 +462,7 @@ struct LottieAnim {
                 std::swap(nextFrame, prerenderedFrames.front());
                 prerenderedFrames.pop();
                 std::swap(currentFrame.data, nextFrame.data);
+                releaseFrameData(nextFrame.data);
                 currentFrame.size = nextFrame.size;
                 currentFrame.pid = pid;
 #if DEBUG_LOTTIE_UPDATE
@@ -247,36 +481,83 @@ struct LottieAnim {
             timeline.last_ms += frameDiff * timeline.duration_ms;
         }
 
-        if (prerenderedFrames.size() <= std::max<int>(maxPrerenderedFrames, DEFAULT_PRERENDERED_FRAMES)) {
-            // calc next prerendered frame index
-            uint16_t nextFrameIndex = frame.current + (uint16_t)prerenderedFrames.size();
+        uint16_t nextFrameIndex = 0;
+        if (nextPrerenderedFrame(nextFrameIndex)) {
+            // create new frame
+            prerenderedFrames.push({});
+            NextFrame &nextFrame = prerenderedFrames.back();
 
-            // if loop we need back to 0 and render again
-            if (loop) {
-                nextFrameIndex = (nextFrameIndex % frame.total);
+            // size for next frame memory
+            size_t bufferSize = canvas.width * canvas.height * LOTTIE_SURFACE_FMT_BPP;
+
+            // create memory block where will be placed frame
+            if (framePool) {
+                nextFrame.data = framePool->acquire(bufferSize);
+            } else {
+                nextFrame.data.resize(bufferSize);
             }
 
-            // not need prerender frames when all finished
-            if (nextFrameIndex < frame.total) {
-                // create new frame
-                prerenderedFrames.push({});
-                NextFrame &nextFrame = prerenderedFrames.back();
+            // save frame size for next actions
+            nextFrame.size = ImVec2((float)canvas.width, (float)canvas.height);
 
-                // size for next frame memory
-                size_t bufferSize = canvas.width * canvas.height * LOTTIE_SURFACE_FMT_BPP;
+            imlottie::animationRenderSync(anim, nextFrameIndex, (uint32_t *)nextFrame.data.data(), canvas.width, canvas.height, canvas.width *LOTTIE_SURFACE_FMT_BPP);
+            return true;
+        }
 
-                // create memory block where will be placed frame
-                nextFrame.data.resize(bufferSize);
+        return false;
+    }
 
-                // save frame size for next actions
-                nextFrame.size = ImVec2((float)canvas.width, (float)canvas.height);
+    void releaseFrameData(std::vector<uint8_t> &data) {
+        if (framePool) {
+            framePool->release(data);
+        }
+    }
 
-                imlottie::animationRenderSync(anim, nextFrameIndex, (uint32_t *)nextFrame.data.data(), canvas.width, canvas.height, canvas.width *LOTTIE_SURFACE_FMT_BPP);
-                return true;
-            }
+    // return memory of all frames to pool, when animation is discarded
+    void releaseFrames() {
+        while (!prerenderedFrames.empty()) {
+            releaseFrameData(prerenderedFrames.front().data);
+            prerenderedFrames.pop();
         }
+        releaseFrameData(currentFrame.data);
 
-        return false;
+        if (ReadyFrame *ready = mailbox->take()) {
+            releaseFrameData(ready->data);
+            mailbox->keep(ready);
+        }
+    }
+
+    // calc index of frame which need prerender, returns false when
+    // prerendered frames array is full or animation finished
+    bool nextPrerenderedFrame(uint16_t &nextFrameIndex) const {
+        if (prerenderedFrames.size() > std::max<int>(maxPrerenderedFrames, DEFAULT_PRERENDERED_FRAMES))
+            return false;
+
+        // calc next prerendered frame index
+        nextFrameIndex = frame.current + (uint16_t)prerenderedFrames.size();
+
+        // if loop we need back to 0 and render again
+        if (loop) {
+            nextFrameIndex = (nextFrameIndex % frame.total);
+        }
+
+        // not need prerender frames when all finished
+        return nextFrameIndex < frame.total;
+    }
+
+    // calc time when render() has work to do: right now while prerendered frames
+    // are not filled, otherwise when current frame duration is over.
+    // returns false when animation stopped and not need render at all
+    bool nextRenderTime(uint32_t curTime, uint32_t &time) const {
+        if (pid == BAD_PICTUREID || suspended || !loaded || !(play || renderonce))
+            return false;
+
+        if (!loop && frame.current > frame.total)
+            return false;
+
+        uint16_t nextFrameIndex = 0;
+        time = nextPrerenderedFrame(nextFrameIndex) ? curTime : timeline.last_ms + timeline.duration_ms;
+        return true;
     }
 
     // Simple helper function to load an image into a DX11 texture with common settings
@@ -385,8 +666,95 @@ struct LottieAnim {
 #endif
 };
 
+// counters of channel between threads, rejected values were not accepted because
+// channel was full and producer should retry or drop them
+struct LottieChannelStats {
+    uint64_t pushed = 0;
+    uint64_t rejected = 0;
+};
+
+// bounded lock-free ring for many producers and one consumer, every cell has sequence
+// number which tells who owns the cell now: producer which claimed the position, or consumer.
+// Producer never waits, when ring is full push() returns false and counts rejected value
+template <typename T, size_t Capacity>
+struct LottieRing {
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "LottieRing capacity must be power of two");
+
+    LottieRing() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // move value to ring, value keep unchanged when ring is full
+    bool push(T &value) {
+        Cell *cell = nullptr;
+        size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & (Capacity - 1)];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        pushed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // must be called only from consumer thread
+    bool pop(T &value) {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        Cell &cell = cells[pos & (Capacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0)
+            return false;
+
+        value = std::move(cell.value);
+        cell.value = T{};
+        cell.sequence.store(pos + Capacity, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // approximate, because producers and consumer can change ring right now
+    size_t size() const {
+        const size_t first = head.load(std::memory_order_relaxed);
+        const size_t last = tail.load(std::memory_order_relaxed);
+        return last > first ? last - first : 0;
+    }
+
+    LottieChannelStats stats() const {
+        LottieChannelStats result;
+        result.pushed = pushed.load(std::memory_order_relaxed);
+        result.rejected = rejected.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell cells[Capacity];
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> rejected{0};
+};
+
 struct LottieRenderCommand {
-    enum Type { UNKNOWN = 0, ADD_CONFIG, DISCARD_PID, SETUP_PID, SETUP_PLAY, SETUP_RENDER };
+    enum Type { UNKNOWN = 0, ADD_CONFIG, DISCARD_PID, SETUP_PID, SETUP_PLAY, SETUP_RENDER, SETUP_VISIBLE };
     Type type;
     std::string path;
     int w, h;
@@ -395,27 +763,299 @@ struct LottieRenderCommand {
     ImGuiID pid;
     bool play;
     bool render;
+    bool visible;
+};
+
+// pool of workers which render independent animations in parallel. Every worker has
+// own queue of tasks, and when it is empty worker steal tasks from the tail of another
+// queues, so one heavy animation does not stall light ones which queued after it.
+// Thread which call run() works as worker 0, so pool with one worker is serial loop
+struct LottieRenderPool {
+    using Job = std::function<void(LottieAnim &)>;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<LottieAnim *> tasks;
+    };
+
+    // default count of workers, leave one core for main (imgui) thread
+    static int defaultWorkersNum() {
+        const int cores = (int)std::thread::hardware_concurrency();
+        return std::max<int>(cores - 1, 1);
+    }
+
+    void start(int workersNum, Job _job) {
+        job = std::move(_job);
+        workersNum = std::max<int>(workersNum > 0 ? workersNum : defaultWorkersNum(), 1);
+        for (int i = 0; i < workersNum; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        // worker 0 is thread which call run()
+        for (int i = 1; i < workersNum; ++i) {
+            threads.emplace_back([this, i] () { workerLoop(i); });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            stopping = true;
+        }
+        batchReady.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    size_t workersNum() const { return workers.size(); }
+
+    // render all animations from list and return when all of them are finished
+    void run(const std::vector<LottieAnim *> &anims) {
+        if (anims.empty()) {
+            return;
+        }
+
+        if (threads.empty()) {
+            for (auto *anim : anims) {
+                job(*anim);
+            }
+            return;
+        }
+
+        // counter must be set before tasks become visible, because worker which
+        // still not leave previous batch can grab them right now
+        pending.store((int)anims.size());
+        for (size_t i = 0; i < anims.size(); ++i) {
+            Worker &worker = *workers[i % workers.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(anims[i]);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(batchMutex);
+            ++batchId;
+        }
+        batchReady.notify_all();
+
+        drain(0);
+
+        std::unique_lock<std::mutex> lock(batchMutex);
+        batchDone.wait(lock, [this] () { return pending.load() == 0; });
+    }
+
+private:
+    bool popTask(size_t index, LottieAnim *&anim) {
+        Worker &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+            return false;
+
+        anim = worker.tasks.front();
+        worker.tasks.pop_front();
+        return true;
+    }
+
+    bool stealTask(size_t index, LottieAnim *&anim) {
+        for (size_t i = 1; i < workers.size(); ++i) {
+            Worker &victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty())
+                continue;
+
+            anim = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void drain(size_t index) {
+        LottieAnim *anim = nullptr;
+        while (pending.load() > 0) {
+            if (!popTask(index, anim) && !stealTask(index, anim)) {
+                // all tasks already taken, another workers finish them
+                return;
+            }
+
+            job(*anim);
+
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(batchMutex);
+                batchDone.notify_all();
+            }
+        }
+    }
+
+    void workerLoop(size_t index) {
+        uint32_t lastBatchId = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(batchMutex);
+                batchReady.wait(lock, [&] () { return stopping || batchId != lastBatchId; });
+                if (stopping)
+                    return;
+                lastBatchId = batchId;
+            }
+            drain(index);
+        }
+    }
+
+    Job job;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex batchMutex;
+    std::condition_variable batchReady;
+    std::condition_variable batchDone;
+    uint32_t batchId = 0;
+    bool stopping = false;
+    std::atomic_int pending{0};
+};
+
+// parse models of new animations on own threads, so render thread keeps rendering
+// existing animations while files are loading. Visible animations are loaded
+// first, in order they were requested
+struct LottieLoadPool {
+    struct Request {
+        uint32_t key = 0;
+        std::shared_ptr<imlottie::Animation> anim;
+        uint64_t order = 0;     // also id of request, starts from 1
+        bool hidden = false;
+    };
+
+    struct Finished {
+        uint32_t key = 0;
+        uint64_t id = 0;
+        bool ok = false;
+    };
+
+    // half of cores, loaders share cpu with render workers
+    static int defaultLoadersNum() {
+        const int cores = (int)std::thread::hardware_concurrency();
+        return std::max<int>(cores / 2, 1);
+    }
+
+    // notify is called from loader thread after every finished load
+    void start(int loadersNum, std::function<void()> _notify) {
+        notify = std::move(_notify);
+        loadersNum = loadersNum > 0 ? loadersNum : defaultLoadersNum();
+        for (int i = 0; i < loadersNum; ++i) {
+            threads.emplace_back([this] () { loaderLoop(); });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            requests.clear();
+        }
+        requestReady.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    // returns id of request, it is unique for pool lifetime and identify finished load
+    uint64_t push(uint32_t key, const std::shared_ptr<imlottie::Animation> &anim) {
+        uint64_t id = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = ++nextOrder;
+            requests.push_back({key, anim, id, false});
+        }
+        requestReady.notify_one();
+        return id;
+    }
+
+    // animation was discarded, its load is not needed anymore
+    void cancel(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.erase(std::remove_if(requests.begin(), requests.end(), [id] (auto &r) { return r.order == id; }), requests.end());
+    }
+
+    // hidden animations are loaded after all visible
+    void setHidden(uint64_t id, bool hidden) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &request : requests) {
+            if (request.order == id) {
+                request.hidden = hidden;
+            }
+        }
+    }
+
+    void takeFinished(std::vector<Finished> &result) {
+        result.clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(result, finished);
+    }
+
+private:
+    void loaderLoop() {
+        while (true) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                requestReady.wait(lock, [this] () { return stopping || !requests.empty(); });
+                if (stopping)
+                    return;
+
+                auto it = std::min_element(requests.begin(), requests.end(), [] (auto &a, auto &b) {
+                    return a.hidden != b.hidden ? !a.hidden : a.order < b.order;
+                });
+                request = std::move(*it);
+                requests.erase(it);
+            }
+
+            const bool ok = imlottie::animationPrepare(request.anim);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.push_back({request.key, request.order, ok});
+            }
+            notify();
+        }
+    }
+
+    std::function<void()> notify;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable requestReady;
+    std::vector<Request> requests;
+    std::vector<Finished> finished;
+    uint64_t nextOrder = 0;
+    bool stopping = false;
 };
 
 // this thread resolve command to load lotti animations, and their render frames
 struct LottieRenderThread {
     std::atomic_int terminating = false;
-    bool popCommand(LottieRenderCommand &command) {
-        std::lock_guard<std::mutex> lock(commandsMutex);
-        if (commands.empty())
-            return false;
+    // workers which render animations, 0 means LottieRenderPool::defaultWorkersNum()
+    int workersNum = 0;
+    // memory for frames of all animations, owned by LottieAnimationRenderer
+    LottieFramePool *framePool = nullptr;
+    LottieRenderPool renderPool;
+    // threads which parse models, 0 means LottieLoadPool::defaultLoadersNum()
+    int loadersNum = 0;
+    LottieLoadPool loadPool;
+    std::vector<LottieLoadPool::Finished> finishedLoads;
+    static constexpr size_t COMMANDS_CAPACITY = 1024;
 
-        std::swap(command, commands.front());
-        commands.pop();
-        return true;
+    bool popCommand(LottieRenderCommand &command) {
+        return commands.pop(command);
     }
 
-    void addCommand(const LottieRenderCommand &command) {
-        if (commands.size() > 100) {
-            return;
+    // returns false when commands ring is full, command was not accepted and caller
+    // should send it again later
+    bool addCommand(LottieRenderCommand command) {
+        if (!commands.push(command)) {
+            return false;
         }
-        std::lock_guard<std::mutex> lock(commandsMutex);
-        commands.push(command);
+        wake();
+        return true;
     }
 
     size_t getCommandNum()
@@ -433,33 +1073,102 @@ struct LottieRenderThread {
     // setup pid - animation need assign PictureID in PM, this pid
     //             received later than load, when we have area in atlas for image
     // setup play flag - for future, when we need change play status
-    std::mutex commandsMutex;
-    std::queue<LottieRenderCommand> commands;
-
-    // this queue contain ready frames from animations, it placed in system
-    // memory that another thread can copy their to PM texture later
-    std::mutex readyFramesMutex;
-    std::queue<ReadyFrame> readyFrames;
+    LottieRing<LottieRenderCommand, COMMANDS_CAPACITY> commands;
+
+    // animations which main thread check for ready frames, every animation
+    // keep newest frame in own mailbox, it placed in system memory that another
+    // thread can copy their to PM texture later. Render thread lock it only when
+    // animation added or discarded, main thread lock it while upload frames
+    std::mutex uploadMutex;
+    std::vector<LottieAnim *> uploadAnimations;
+    std::atomic<uint64_t> readyFramesPosted{0};
+    std::atomic<uint64_t> readyFramesSuperseded{0};
+
+    // time of main thread (ImGui::GetTime() in ms) received on last sync, between syncs
+    // render thread extrapolate it with steady clock. Guarded by wakeMutex
     float curtime = 0;
+    std::chrono::steady_clock::time_point curtimeStamp = std::chrono::steady_clock::now();
+
+    // render thread sleeps on wakeup until earliest frame deadline, new command or terminate
+    std::mutex wakeMutex;
+    std::condition_variable wakeup;
+    bool wakeRequested = false;
+
+    // min-heap of frame deadlines, key is key of animation in animations map. Entries are
+    // not removed when animation discarded or rescheduled, so it checked when popped
+    struct FrameDeadline {
+        uint32_t time_ms;
+        uint32_t key;
+        bool operator>(const FrameDeadline &other) const { return time_ms > other.time_ms; }
+    };
+    std::priority_queue<FrameDeadline, std::vector<FrameDeadline>, std::greater<FrameDeadline>> deadlines;
+
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wakeRequested = true;
+        }
+        wakeup.notify_one();
+    }
 
-    void pushReadyFrame(ReadyFrame &frame, size_t maxAnimSize) {
-        std::lock_guard<std::mutex> lock(readyFramesMutex);
-        // remove extra frames, that avoid creating infinite queue
-        if (readyFrames.size() > maxAnimSize)
-            readyFrames.pop();
+    void terminate() {
+        terminating.store(true);
+        wake();
+    }
 
-        readyFrames.push({});
-        std::swap(readyFrames.back(), frame);
+    // called from main thread with current ImGui time
+    void syncTime(float time) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            curtime = time;
+            curtimeStamp = std::chrono::steady_clock::now();
+        }
+#ifdef IMLOTTIE_SIMPLE_IMPLEMENTATION
+        // simple implementation render frames only when time changed
+        wakeup.notify_one();
+#endif
     }
 
-    bool popReadyFrame(ReadyFrame &frame) {
-        std::lock_guard<std::mutex> lock(readyFramesMutex);
-        if (readyFrames.empty())
-            return false;
+    uint32_t now() {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - curtimeStamp);
+        return (uint32_t)(curtime + elapsed.count());
+    }
 
-        std::swap(frame, readyFrames.front());
-        readyFrames.pop();
-        return true;
+    // put animation to deadlines heap, if it already has earlier deadline then keep it
+    void schedule(uint32_t key, LottieAnim &anim, uint32_t curTime) {
+        uint32_t time = 0;
+        if (!anim.nextRenderTime(curTime, time))
+            return;
+
+        if (anim.timeline.scheduled && anim.timeline.next_ms <= time)
+            return;
+
+        anim.timeline.next_ms = time;
+        anim.timeline.scheduled = true;
+        deadlines.push({time, key});
+    }
+
+    // sleep until earliest deadline, or until new command arrived
+    void waitNextDeadline() {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        auto woken = [this] () { return wakeRequested || terminating.load(); };
+        if (deadlines.empty()) {
+            wakeup.wait(lock, woken);
+        } else {
+            const float waitMs = (float)deadlines.top().time_ms - curtime;
+            const auto until = curtimeStamp + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(waitMs));
+            wakeup.wait_until(lock, until, woken);
+        }
+        wakeRequested = false;
+    }
+
+    // rejected are frames which were replaced by newer before main thread upload them
+    LottieChannelStats readyFramesStats() const {
+        LottieChannelStats result;
+        result.pushed = readyFramesPosted.load(std::memory_order_relaxed);
+        result.rejected = readyFramesSuperseded.load(std::memory_order_relaxed);
+        return result;
     }
 
     // resolve command in thread, because it can be added async from another thread
@@ -468,17 +1177,24 @@ struct LottieRenderThread {
         case LottieRenderCommand::ADD_CONFIG:
         {
             LottieAnim anim;
+            anim.framePool = framePool;
+            // only header is read here, model is parsed by load pool
             bool loadOk = anim.load(cmd.path.c_str(), cmd.w, cmd.h, cmd.loop, true, 2, cmd.rate, cmd.pid);
             if (loadOk) {
-                animations.insert({cmd.pid, std::move(anim)});
+                auto it = animations.insert({cmd.pid, std::move(anim)}).first;
+                {
+                    std::lock_guard<std::mutex> lock(uploadMutex);
+                    uploadAnimations.push_back(&it->second);
+                }
+                it->second.loadId = loadPool.push(it->first, it->second.anim);
             }
         } break;
 
         case LottieRenderCommand::DISCARD_PID:
         {
             auto it = animations.find(cmd.pid);
-            if (animations.find(cmd.pid) != animations.end()) {
-                animations.erase(it);
+            if (it != animations.end()) {
+                discard(it);
             }
         } break;
 
@@ -488,6 +1204,7 @@ struct LottieRenderThread {
             auto it = animations.find(propsHash);
             if (it != animations.end()) {
                 it->second.pid = cmd.pid;
+                schedule(it->first, it->second, now());
             }
         } break;
 
@@ -496,6 +1213,7 @@ struct LottieRenderThread {
             auto it = std::find_if( animations.begin(), animations.end(), [pid = cmd.pid](auto &a) { return a.second.pid == pid; });
             if (it != animations.end()) {
                 it->second.play = cmd.play;
+                schedule(it->first, it->second, now());
             }
         } break;
 
@@ -504,6 +1222,23 @@ struct LottieRenderThread {
             auto it = std::find_if( animations.begin(), animations.end(), [pid = cmd.pid](auto &a) { return a.second.pid == pid; });
             if (it != animations.end()) {
                 it->second.renderonce = cmd.render;
+                schedule(it->first, it->second, now());
+            }
+        } break;
+
+        case LottieRenderCommand::SETUP_VISIBLE:
+        {
+            auto it = std::find_if( animations.begin(), animations.end(), [pid = cmd.pid](auto &a) { return a.second.pid == pid; });
+            if (it != animations.end()) {
+                loadPool.setHidden(it->second.loadId, !cmd.visible);
+                if (cmd.visible) {
+                    it->second.resume(now());
+                    schedule(it->first, it->second, now());
+                } else {
+                    // deadline in heap become stale and will be skipped
+                    it->second.suspend();
+                    it->second.timeline.scheduled = false;
+                }
             }
         } break;
 
@@ -513,69 +1248,131 @@ struct LottieRenderThread {
         }
     }
 
+    void discard(std::unordered_map<uint32_t, LottieAnim>::iterator it) {
+        {
+            // main thread can upload frame of this animation right now
+            std::lock_guard<std::mutex> lock(uploadMutex);
+            uploadAnimations.erase(std::remove(uploadAnimations.begin(), uploadAnimations.end(), &it->second), uploadAnimations.end());
+        }
+        loadPool.cancel(it->second.loadId);
+        it->second.releaseFrames();
+        animations.erase(it);
+    }
+
+    // start render animations which models are parsed, animation could be
+    // discarded (or discarded and added again) while its model was loading
+    void resolveLoads() {
+        loadPool.takeFinished(finishedLoads);
+        for (auto &load : finishedLoads) {
+            auto it = animations.find(load.key);
+            if (it == animations.end() || it->second.loadId != load.id)
+                continue;
+
+            if (!load.ok) {
+                printf("Lottie::animation load failed from <%s>", it->second.lottiePath.c_str());
+                discard(it);
+                continue;
+            }
+
+            it->second.loaded = true;
+            schedule(it->first, it->second, now());
+        }
+    }
+
     void execute() {
+        loadPool.start(loadersNum, [this] () { wake(); });
+
+        // animations map changes only on this thread between pool runs,
+        // so workers can use pointers to animations while batch is rendering
+        uint32_t frameTime = 0;
+        renderPool.start(workersNum, [this, &frameTime] (LottieAnim &anim) {
+            // frame render make a time, skip rest of batch when thread want stop
+            if (terminating.load())
+                return;
+
+            // prerender next frames and prepare copy data to current frame if need
+            anim.render(frameTime);
+
+            // if current frame ready, we need move it to mailbox of animation,
+            // it will be copied to dynatlas on frame update from main thread
+            if (anim.currentFrame.pid != BAD_PICTUREID) {
+                readyFramesPosted.fetch_add(1, std::memory_order_relaxed);
+                if (!anim.postCurrentFrame()) {
+                    readyFramesSuperseded.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        std::vector<LottieAnim *> batch;
+        std::vector<uint32_t> batchKeys;
         while (!terminating.load()) {
             LottieRenderCommand cmd;
-            if (popCommand(cmd)) {
+            while (popCommand(cmd)) {
                 resolveCommand(cmd);
             }
-
-            if (animations.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000/30));
+            resolveLoads();
+
+            // collect animations which deadline is come
+            frameTime = now();
+            batch.clear();
+            batchKeys.clear();
+            while (!deadlines.empty() && deadlines.top().time_ms <= frameTime) {
+                const FrameDeadline deadline = deadlines.top();
+                deadlines.pop();
+
+                // animation was discarded or rescheduled after this deadline
+                auto it = animations.find(deadline.key);
+                if (it == animations.end() || !it->second.timeline.scheduled || it->second.timeline.next_ms != deadline.time_ms)
+                    continue;
+
+                it->second.timeline.scheduled = false;
+                batch.push_back(&it->second);
+                batchKeys.push_back(it->first);
             }
 
             // render animations and extract current animation frame to ready frames array
-            const size_t maxAnimSize = animations.size() * 2;
-            for (auto &anim : animations) {
-                // it's loop here for all animations and frame render make a time, break
-                // it when thread want stop
-                if (terminating.load())
-                    return;
-
-                // prerender next frames and prepare copy data to current frame if need
-                anim.second.render((uint32_t)curtime);
+            renderPool.run(batch);
 
-                // if current frame ready, we need copy it to ready frames array
-                // ready frames array will be copied to dynatlas on frame update from
-                // main thread so we need use mutex for guard access when array changes
-                ReadyFrame currentFrame;
-                if (anim.second.grabCurrentFrame(currentFrame)) {
-                    pushReadyFrame(currentFrame, maxAnimSize);
-                }
+            for (size_t i = 0; i < batch.size(); ++i) {
+                schedule(batchKeys[i], *batch[i], frameTime);
             }
+
+            waitNextDeadline();
         }
+
+        renderPool.stop();
+        loadPool.stop();
     }
 
 #ifdef IMLOTTIE_SIMPLE_IMPLEMENTATION
     void simpleExecute() {
-        uint32_t lasttime = 0;
-        size_t commandNum = 0;
+        loadPool.start(loadersNum, [this] () { wake(); });
+
+        float lasttime = 0;
         LottieRenderCommand cmd;
         while (!terminating.load()) {
-            if (commandNum != getCommandNum()) {
-                if (popCommand(cmd)) {
-                    resolveCommand(cmd);
-                }
+            while (popCommand(cmd)) {
+                resolveCommand(cmd);
             }
-
-            if (animations.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
+            resolveLoads();
+
+            // sleep until main thread sync new time or send command
+            float frameTime = 0;
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeup.wait(lock, [&] () { return wakeRequested || terminating.load() || curtime != lasttime; });
+                wakeRequested = false;
+                frameTime = curtime;
             }
 
-            if (lasttime != curtime) {
+            if (lasttime != frameTime) {
                 for (auto& [key, value] : animations) {
-                    value.updateCurtimeFrame((uint32_t)curtime);
+                    value.updateCurtimeFrame((uint32_t)frameTime);
                 }
             }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000/30));
-            }
-            lasttime = curtime;
+            lasttime = frameTime;
         }
+        loadPool.stop();
     }
 #endif
 };
@@ -586,14 +1383,25 @@ struct LottieAnimDesc {
     ImVec2 size;
     void *srv = nullptr;
     ImGuiID pid = BAD_PICTUREID;
+    // ImGui frame when animation was submitted last time
+    int lastSubmitFrame = 0;
+    bool suspended = false;
+    // animations are added playing, render thread schedules their frames itself
+    bool playing = true;
 };
 
 struct LottieAnimationRenderer {
+    // declared before render thread, because animations return memory here until thread stopped
+    LottieFramePool framePool;
     LottieRenderThread renderThread;
 
     std::mutex animationsPresentMutex;
     std::unordered_map<ImGuiID, LottieAnimDesc> animationsPresent;
 
+    // animation which was not submitted this count of ImGui frames is suspended
+    // (window collapsed or item scrolled away) until it will be submitted again
+    int suspendAfterFrames = 2;
+
     ImGuiID match(const char *path, int w, int h, bool loop, int rate) {
         if (!path || 0 == *path) {
             return false;
@@ -606,10 +1414,6 @@ struct LottieAnimationRenderer {
             ImVec2 prefferedSize;
             prefferedSize.x = (float)std::max<int>(w, LottieAnim::DEFAULT_SIZE);
             prefferedSize.y = (float)std::max<int>(h, LottieAnim::DEFAULT_SIZE);
-            LottieAnimDesc animDesc;
-            animDesc.pid = propsHash;
-            animDesc.size = prefferedSize;
-            animationsPresent.insert({propsHash, animDesc});
 
             LottieRenderCommand command;
             command.type = LottieRenderCommand::ADD_CONFIG;
@@ -619,20 +1423,75 @@ struct LottieAnimationRenderer {
             command.loop = loop;
             command.rate = rate;
             command.pid = propsHash;
-            renderThread.addCommand(command);
+
+            // commands ring is full, animation will be registered on next match() call
+            if (!renderThread.addCommand(std::move(command))) {
+                return propsHash;
+            }
+
+            LottieAnimDesc animDesc;
+            animDesc.pid = propsHash;
+            animDesc.size = prefferedSize;
+            animDesc.lastSubmitFrame = ImGui::GetFrameCount();
+            animationsPresent.insert({propsHash, animDesc});
             return propsHash;
         }
 
         return propsHash;
     }
 
+    // called every ImGui frame, command is sent only while it changes something:
+    // animation is paused or has no texture yet, playing one is already scheduled
     bool render(ImGuiID pid) {
+        {
+            std::lock_guard<std::mutex> lock(animationsPresentMutex);
+            auto it = animationsPresent.find(pid);
+            if (it != animationsPresent.end() && it->second.playing && it->second.srv) {
+                return true;
+            }
+        }
+
         LottieRenderCommand command;
         command.type = LottieRenderCommand::SETUP_RENDER;
         command.pid = pid;
         command.render = true;
-        renderThread.addCommand(command);
-        return true;
+        return renderThread.addCommand(std::move(command));
+    }
+
+    // called every ImGui frame when animation is visible, resume it if it was suspended
+    void submit(ImGuiID pid) {
+        std::lock_guard<std::mutex> lock(animationsPresentMutex);
+        auto it = animationsPresent.find(pid);
+        if (it == animationsPresent.end())
+            return;
+
+        it->second.lastSubmitFrame = ImGui::GetFrameCount();
+        if (it->second.suspended && setVisible(pid, true)) {
+            it->second.suspended = false;
+        }
+    }
+
+    // suspend animations which were not submitted last suspendAfterFrames frames,
+    // if commands ring is full it will be tried again on next frame
+    void suspendHidden() {
+        const int frameCount = ImGui::GetFrameCount();
+        std::lock_guard<std::mutex> lock(animationsPresentMutex);
+        for (auto &[key, desc] : animationsPresent) {
+            if (desc.suspended || frameCount - desc.lastSubmitFrame < suspendAfterFrames)
+                continue;
+
+            if (setVisible(desc.pid, false)) {
+                desc.suspended = true;
+            }
+        }
+    }
+
+    bool setVisible(ImGuiID pid, bool visible) {
+        LottieRenderCommand command;
+        command.type = LottieRenderCommand::SETUP_VISIBLE;
+        command.pid = pid;
+        command.visible = visible;
+        return renderThread.addCommand(std::move(command));
     }
 
     void *image(ImGuiID pid) {
@@ -641,70 +1500,114 @@ struct LottieAnimationRenderer {
         return (it == animationsPresent.end()) ? nullptr : it->second.srv;
     }
 
-    void play(ImGuiID pid, bool play) {
+    // returns false when commands ring is full, call it again later
+    bool play(ImGuiID pid, bool play) {
         LottieRenderCommand command;
         command.type = LottieRenderCommand::SETUP_PLAY;
         command.pid = pid;
         command.play = play;
-        renderThread.addCommand(command);
+        if (!renderThread.addCommand(std::move(command))) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(animationsPresentMutex);
+        auto it = animationsPresent.find(pid);
+        if (it != animationsPresent.end()) {
+            it->second.playing = play;
+        }
+        return true;
     }
 
-    void discard(ImGuiID pid) {
+    // returns false when commands ring is full, call it again later
+    bool discard(ImGuiID pid) {
         LottieRenderCommand command;
         command.type = LottieRenderCommand::DISCARD_PID;
         command.pid = pid;
-        renderThread.addCommand(command);
+        if (!renderThread.addCommand(std::move(command))) {
+            return false;
+        }
 
         std::lock_guard<std::mutex> lock(animationsPresentMutex);
         auto it = std::find_if(animationsPresent.begin(), animationsPresent.end(), [pid] (auto &a) { return a.second.pid == pid; });
         if (it != animationsPresent.end()) {
             animationsPresent.erase(it);
         }
+        return true;
     }
 
+    // rejected counters show how many commands and frames were not accepted
+    // because channel between threads was full
+    LottieChannelStats commandsStats() const { return renderThread.commands.stats(); }
+    LottieChannelStats readyFramesStats() const { return renderThread.readyFramesStats(); }
+
+    LottieFramePoolStats framePoolStats() { return framePool.getStats(); }
+
+    // free memory of frames which wait in pool, keep no more than maxPooledBytes
+    void trimFramePool(size_t maxPooledBytes = 0) { framePool.trim(maxPooledBytes); }
+
 #ifdef IMLOTTIE_DX11_IMPLEMENTATION
     void uploadReadyFramesToSysTex(ID3D11Device *pd3dDevice, ID3D11DeviceContext* ctx) {
-        // prepared frames stored in readyFrames array now (in system memory)
+        // newest frames stored in mailboxes of animations now (in system memory)
         // but need move those to gpu memory with textures
-        ReadyFrame readyFrame;
-        while (renderThread.popReadyFrame(readyFrame)) {
-            const auto &it = renderThread.animations.find(readyFrame.pid);
+        std::lock_guard<std::mutex> lock(renderThread.uploadMutex);
+        bool textureCreated = false;
+        for (LottieAnim *anim : renderThread.uploadAnimations) {
+            // create only one texture per frame, another wait for next frames
+            if (!anim->texture && textureCreated)
+                continue;
+
+            ReadyFrame *readyFrame = anim->mailbox->take();
+            if (!readyFrame)
+                continue;
 
-            if (!it->second.texture) {
-                it->second.createTextureFromData(readyFrame.data.data(), pd3dDevice);
-                auto rit = std::find_if(animationsPresent.begin(), animationsPresent.end(), [pid = it->second.pid] (auto &a) { return a.second.pid == pid; });
+            if (!anim->texture) {
+                anim->createTextureFromData(readyFrame->data.data(), pd3dDevice);
+                auto rit = std::find_if(animationsPresent.begin(), animationsPresent.end(), [pid = anim->pid] (auto &a) { return a.second.pid == pid; });
                 if (rit != animationsPresent.end())
-                    rit->second.srv = it->second.srv;
-                break;
+                    rit->second.srv = anim->srv;
+                textureCreated = true;
             } else {
-                it->second.updateTextureFromData(readyFrame.data.data(), ctx);
+                anim->updateTextureFromData(readyFrame->data.data(), ctx);
             }
+            framePool.release(readyFrame->data);
+            anim->mailbox->recycle(readyFrame);
         }
 
-        renderThread.curtime = (float)ImGui::GetTime() * 1000.f;
+        suspendHidden();
+        renderThread.syncTime((float)ImGui::GetTime() * 1000.f);
     }
 #endif // IMLOTTIE_DX11_IMPLEMENTATION
 
 #ifdef IMLOTTIE_OPENGL_IMPLEMENTATION
     void uploadReadyFramesToSysTex() {
-        // prepared frames stored in readyFrames array now (in system memory)
+        // newest frames stored in mailboxes of animations now (in system memory)
         // but need move those to gpu memory with textures
-        ReadyFrame readyFrame;
-        while (renderThread.popReadyFrame(readyFrame)) {
-            const auto &it = renderThread.animations.find(readyFrame.pid);
+        std::lock_guard<std::mutex> lock(renderThread.uploadMutex);
+        bool textureCreated = false;
+        for (LottieAnim *anim : renderThread.uploadAnimations) {
+            // create only one texture per frame, another wait for next frames
+            if (!anim->texture && textureCreated)
+                continue;
 
-            if (!it->second.texture) {
-                it->second.createTextureFromData(readyFrame.data.data());
-                auto rit = std::find_if(animationsPresent.begin(), animationsPresent.end(), [pid = it->second.pid] (auto &a) { return a.second.pid == pid; });
+            ReadyFrame *readyFrame = anim->mailbox->take();
+            if (!readyFrame)
+                continue;
+
+            if (!anim->texture) {
+                anim->createTextureFromData(readyFrame->data.data());
+                auto rit = std::find_if(animationsPresent.begin(), animationsPresent.end(), [pid = anim->pid] (auto &a) { return a.second.pid == pid; });
                 if (rit != animationsPresent.end())
-                    rit->second.srv = (ImTextureID)(intptr_t)it->second.srv;
-                break;
+                    rit->second.srv = (ImTextureID)(intptr_t)anim->srv;
+                textureCreated = true;
             } else {
-                it->second.updateTextureFromData(readyFrame.data.data());
+                anim->updateTextureFromData(readyFrame->data.data());
             }
+            framePool.release(readyFrame->data);
+            anim->mailbox->recycle(readyFrame);
         }
 
-        renderThread.curtime = (float)ImGui::GetTime() * 1000.f;
+        suspendHidden();
+        renderThread.syncTime((float)ImGui::GetTime() * 1000.f);
     }
 
 #ifdef IMLOTTIE_SIMPLE_IMPLEMENTATION
@@ -723,13 +1626,17 @@ struct LottieAnimationRenderer {
                 anim_.updateTextureFromData(anim_.currentFrame.data.data());
             }
         }
-        renderThread.curtime = (float)ImGui::GetTime() * 1000.f;
+        suspendHidden();
+        renderThread.syncTime((float)ImGui::GetTime() * 1000.f);
     }
 #endif
 
 #endif
 
-    LottieAnimationRenderer() : independedThread{}  {
+    // workersNum - how many threads render animations, 0 means hardware_concurrency - 1
+    LottieAnimationRenderer(int workersNum = 0) : independedThread{}  {
+        renderThread.workersNum = workersNum;
+        renderThread.framePool = &framePool;
 #ifdef IMLOTTIE_SIMPLE_IMPLEMENTATION
         independedThread = std::thread([this] () { renderThread.simpleExecute(); });
 #else
@@ -738,7 +1645,7 @@ struct LottieAnimationRenderer {
     }
 
     ~LottieAnimationRenderer() {
-        renderThread.terminating.store(true);
+        renderThread.terminate();
         independedThread.join();
     }
     private:
@@ -767,6 +1674,7 @@ void LottieAnimation(const char *path, const ImVec2 &size, bool loop, int rate)
     assert(detail::g_lottieRenderer);
     if (detail::g_lottieRenderer) {
         ImGuiID rid = detail::g_lottieRenderer->match(path, size.x, size.y, loop, rate);
+        detail::g_lottieRenderer->submit(rid);
 #ifndef IMLOTTIE_SIMPLE_IMPLEMENTATION
         detail::g_lottieRenderer->render(rid); // not really render, just send command to stack we need this texture
 #endif
@@ -799,6 +1707,7 @@ void LottieAnimation(const char *path, const ImVec2 &animSize, const ImVec2 &siz
     assert(detail::g_lottieRenderer);
     if (detail::g_lottieRenderer) {
         ImGuiID rid = detail::g_lottieRenderer->match(path, animSize.x, animSize.y, loop, rate);
+        detail::g_lottieRenderer->submit(rid);
 #ifndef IMLOTTIE_SIMPLE_IMPLEMENTATION
         detail::g_lottieRenderer->render(rid); // not really render, just send command to stack we need this texture
 #endif
@@ -810,8 +1719,9 @@ void LottieAnimation(const char *path, const ImVec2 &animSize, const ImVec2 &siz
 }
 
 
-void init() {
-    detail::g_lottieRenderer = new LottieAnimationRenderer();
+// workersNum - how many threads render animations, 0 means hardware_concurrency - 1
+void init(int workersNum = 0) {
+    detail::g_lottieRenderer = new LottieAnimationRenderer(workersNum);
 }
 
 void destroy() {
@@ -17,12 +17,17 @@
  */
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <assert.h>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <future>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <algorithm>
 #include <cmath>
 #include <iterator>
@@ -32,6 +37,7 @@
 #include <array>
 #include <bitset>
 #include <deque>
+#include <thread>
 
 #ifdef __cplusplus
 extern "C" {
@@ -124,6 +130,7 @@ struct RjValue
 struct RjInsituStringStream
 {
     RjInsituStringStream(char* str);
+    void reset(char* str);
     void* ss_ = nullptr;
 };
 
@@ -788,6 +795,10 @@ public:
         Project = 0x10
     };
     VMatrix() = default;
+    VMatrix(float h11, float h12, float h13, float h21, float h22, float h23,
+            float dx, float dy, float h33)
+        : m11(h11), m12(h12), m13(h13), m21(h21), m22(h22), m23(h23),
+          mtx(dx), mty(dy), m33(h33), dirty(MatrixType::Project) {}
     bool         isAffine() const {
         return type() < MatrixType::Project;
     }
@@ -1450,6 +1461,9 @@ public:
     VRect boundingRect() const { return d->bbox(); }
     void setBoundingRect(const VRect &bbox) { d->setBbox(bbox); }
     void addSpan(const VRle::Span *span, size_t count) { d.write().addSpan(span, count); }
+    // keep `written` spans of table returned by previous call and return
+    // table for `reserve` more spans at the end, 0 reserve finish writing
+    Span *appendSpans(size_t written, size_t reserve) { return d.write().appendSpans(written, reserve); }
 
     void reset() { d.write().reset(); }
     void translate(const VPoint &p) { d.write().translate(p); }
@@ -1514,6 +1528,7 @@ public:
         };
         bool  empty() const { return mSpans.empty(); }
         void  addSpan(const VRle::Span *span, size_t count);
+        VRle::Span *appendSpans(size_t written, size_t reserve);
         void  updateBbox() const;
         VRect bbox() const;
         void setBbox(const VRect &bbox) const;
@@ -1528,6 +1543,7 @@ public:
         void  addRect(const VRect &rect);
         void  clone(const VRle::VRleData &);
         std::vector<VRle::Span> mSpans;
+        size_t                  mReserved{0};  // unwritten tail of mSpans
         VPoint                  mOffset;
         mutable VRect           mBbox;
         mutable bool            mBboxDirty = true;
@@ -2125,6 +2141,7 @@ public:
     void    fill(uint pixel);
     void    updateLuma();
 private:
+    friend class VImageCache;
     struct Impl {
         std::unique_ptr<uchar[]> mOwnData{nullptr};
         uchar *         mRoData{nullptr};
@@ -2538,8 +2555,21 @@ public:
     float value(float aX) const;
     void GetSplineDerivativeValues(float aX, float& aDX, float& aDY) const;
 
+    // sample easing curve to table, value() then interpolates between entries
+    // instead of solving the curve. Table grows until linear interpolation stays
+    // within maxError, false (and no table) when it can't within kMaxTableSize
+    bool buildTable(float maxError);
+    size_t tableSize() const { return mTable.size(); }
+
+    VPointF p1() const { return VPointF(mX1, mY1); }
+    VPointF p2() const { return VPointF(mX2, mY2); }
+
 private:
+    static constexpr size_t kMinTableSize = 16;
+    static constexpr size_t kMaxTableSize = 4096;
+
     void CalcSampleValues();
+    float solve(float aX) const;
 
     /**
     * Returns x(t) given t, x1, and x2, or y(t) given t, y1, and y2.
@@ -2566,32 +2596,136 @@ private:
     float mX2;
     float mY2;
     float              mSampleValues[kSplineTableSize];
+    std::vector<float> mTable;
 };
 
+// Block arena: objects are placed one after another in big blocks, which grow
+// geometrically from first allocation size. Destructors of non trivial objects
+// are called in reverse order when arena is destroyed, memory is freed only then
 class VArenaAlloc {
 public:
-    VArenaAlloc(char*, size_t, size_t) {}
+    // when block is given it used first, arena not own it
+    VArenaAlloc(char *block, size_t blockSize, size_t firstHeapAllocation)
+        : mCursor(block), mEnd(block ? block + blockSize : nullptr),
+          mNextBlockSize(std::max<size_t>(firstHeapAllocation, MIN_BLOCK_SIZE)),
+          mBytesAllocated(block ? blockSize : 0)
+    {}
 
     explicit VArenaAlloc(size_t firstHeapAllocation)
         : VArenaAlloc(nullptr, 0, firstHeapAllocation)
     {}
 
-    ~VArenaAlloc() {}
+    VArenaAlloc(const VArenaAlloc &) = delete;
+    VArenaAlloc &operator=(const VArenaAlloc &) = delete;
+
+    ~VArenaAlloc() {
+        for (Finalizer *f = mFinalizers; f;) {
+            Finalizer *next = f->next;
+            f->destroy(f->object, f->count);
+            f = next;
+        }
+        for (Block *b = mBlocks; b;) {
+            Block *next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
 
     template <typename T, typename... Args>
     T* make(Args&&... args) {
-        return new T(std::forward<Args>(args)...);
+        T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        addFinalizer(object, 1);
+        return object;
     }
 
     template <typename T>
     T* makeArrayDefault(size_t count) {
-        return new T[count];
+        T *array = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; i++) new (array + i) T;
+        addFinalizer(array, count);
+        return array;
     }
 
     template <typename T>
     T* makeArray(size_t count) {
-        return new T[count];
+        T *array = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; i++) new (array + i) T();
+        addFinalizer(array, count);
+        return array;
+    }
+
+    // bytes given to objects and destructor records
+    size_t bytesUsed() const { return mBytesUsed; }
+    // bytes of all blocks, including unused tails
+    size_t bytesAllocated() const { return mBytesAllocated; }
+
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 256;
+    static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    struct Block {
+        Block *next;
+    };
+
+    struct Finalizer {
+        void     (*destroy)(void *, size_t);
+        void      *object;
+        size_t     count;
+        Finalizer *next;
+    };
+
+    template <typename T>
+    void addFinalizer(T *object, size_t count) {
+        if (std::is_trivially_destructible<T>::value) return;
+
+        auto f = static_cast<Finalizer *>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+        f->destroy = [](void *p, size_t n) {
+            T *array = static_cast<T *>(p);
+            while (n) array[--n].~T();
+        };
+        f->object = object;
+        f->count = count;
+        f->next = mFinalizers;
+        mFinalizers = f;
     }
+
+    void *allocate(size_t size, size_t alignment) {
+        char *p = align(mCursor, alignment);
+        if (!p || p + size > mEnd) {
+            newBlock(size + alignment);
+            p = align(mCursor, alignment);
+        }
+        mCursor = p + size;
+        mBytesUsed += size;
+        return p;
+    }
+
+    void newBlock(size_t minSize) {
+        const size_t header = sizeof(Block) + alignof(std::max_align_t);
+        const size_t size = std::max(mNextBlockSize, minSize + header);
+        mNextBlockSize = std::min(mNextBlockSize * 2, MAX_BLOCK_SIZE);
+
+        Block *block = static_cast<Block *>(::operator new(size));
+        block->next = mBlocks;
+        mBlocks = block;
+        mCursor = reinterpret_cast<char *>(block) + sizeof(Block);
+        mEnd = reinterpret_cast<char *>(block) + size;
+        mBytesAllocated += size;
+    }
+
+    static char *align(char *p, size_t alignment) {
+        if (!p) return nullptr;
+        const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char *>((v + alignment - 1) & ~uintptr_t(alignment - 1));
+    }
+
+    char      *mCursor{nullptr};
+    char      *mEnd{nullptr};
+    Block     *mBlocks{nullptr};
+    Finalizer *mFinalizers{nullptr};
+    size_t     mNextBlockSize;
+    size_t     mBytesUsed{0};
+    size_t     mBytesAllocated{0};
 };
 
 using lottie_image_load_f = unsigned char *(*)(const char *filename, int *x, int *y, int *comp, int req_comp);
@@ -2617,24 +2751,19 @@ struct VImageLoader::Impl {
     VBitmap createBitmap(unsigned char *data, int width, int height,
                          int channel)
     {
-        // premultiply alpha
-        if (channel == 4)
-            convertToBGRAPremul(data, width, height);
-        else
-            convertToBGRA(data, width, height);
-
-        // create a bitmap of same size.
         VBitmap result =
             VBitmap(width, height, VBitmap::Format::ARGB32_Premultiplied);
 
-        // copy the data to bitmap buffer
-        memcpy(result.data(), data, width * height * 4);
+        // converted straight into bitmap, premultiply when alpha is present
+        convertToBGRA(data, result, channel == 4);
 
         // free the image data
         imageFree(data);
 
         return result;
     }
+    static void convertToBGRA(const unsigned char *rgba, VBitmap &bitmap,
+                              bool premultiply);
 
     VBitmap load(const char *fileName)
     {
@@ -2664,43 +2793,6 @@ struct VImageLoader::Impl {
 
         return createBitmap(data, width, height, n);
     }
-    /*
-    * convert from RGBA to BGRA and premultiply
-    */
-    void convertToBGRAPremul(unsigned char *bits, int width, int height)
-    {
-        int            pixelCount = width * height;
-        unsigned char *pix = bits;
-        for (int i = 0; i < pixelCount; i++) {
-            unsigned char r = pix[0];
-            unsigned char g = pix[1];
-            unsigned char b = pix[2];
-            unsigned char a = pix[3];
-
-            r = (r * a) / 255;
-            g = (g * a) / 255;
-            b = (b * a) / 255;
-
-            pix[0] = b;
-            pix[1] = g;
-            pix[2] = r;
-
-            pix += 4;
-        }
-    }
-
-    void convertToBGRA(unsigned char *bits, int width, int height)
-    {
-        int            pixelCount = width * height;
-        unsigned char *pix = bits;
-        for (int i = 0; i < pixelCount; i++) {
-            unsigned char r = pix[0];
-            unsigned char b = pix[2];
-            pix[0] = b;
-            pix[2] = r;
-            pix += 4;
-        }
-    }
 };
 
 enum class MatteType: uchar
@@ -2747,7 +2839,8 @@ struct LOTModelStat
     uint16_t shapeLayerCount{0};
     uint16_t imageLayerCount{0};
     uint16_t nullLayerCount{0};
-
+    size_t   sourceBytes{0};  // size of json which model was parsed from
+    size_t   imageBytes{0};   // decoded image assets
 };
 
 template<typename T>
@@ -2758,8 +2851,8 @@ inline T lerp(const T& start, const T& end, float t)
 
 template <typename T>
 struct LOTKeyFrameValue {
-    T mStartValue;
-    T mEndValue;
+    T mStartValue{};
+    T mEndValue{};
     T value(float t) const { return lerp(mStartValue, mEndValue, t); }
     float angle(float ) const { return 0;}
 };
@@ -3106,11 +3199,8 @@ public:
         if(mKeyFrames.back().mEndFrame <= frameNo)
             return mKeyFrames.back().mValue.mEndValue;
 
-        for(const auto &keyFrame : mKeyFrames) {
-            if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame)
-                return keyFrame.value(frameNo);
-        }
-        return T();
+        const LOTKeyFrame<T> *keyFrame = keyFrameAt(frameNo);
+        return keyFrame ? keyFrame->value(frameNo) : T();
     }
 
     float angle(int frameNo) const {
@@ -3118,11 +3208,44 @@ public:
             (mKeyFrames.back().mEndFrame <= frameNo) )
             return 0;
 
-        for(const auto &keyFrame : mKeyFrames) {
-            if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame)
-                return keyFrame.angle(frameNo);
+        const LOTKeyFrame<T> *keyFrame = keyFrameAt(frameNo);
+        return keyFrame ? keyFrame->angle(frameNo) : 0;
+    }
+
+    // keyframe which contains frameNo. Playback is monotonic, so last found keyframe
+    // or next one usually match, otherwise keyframes (sorted by time) are searched
+    // with binary search. Model is shared between threads, cursor is only a hint
+    const LOTKeyFrame<T> *keyFrameAt(int frameNo) const {
+        auto contains = [frameNo](const LOTKeyFrame<T> &keyFrame) {
+            return frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame;
+        };
+
+        const size_t count = mKeyFrames.size();
+        size_t i = mCursor.load(std::memory_order_relaxed);
+        if (i < count && contains(mKeyFrames[i]))
+            return &mKeyFrames[i];
+        if (i + 1 < count && contains(mKeyFrames[i + 1])) {
+            mCursor.store(uint32_t(i + 1), std::memory_order_relaxed);
+            return &mKeyFrames[i + 1];
         }
-        return 0;
+
+        auto it = std::upper_bound(mKeyFrames.begin(), mKeyFrames.end(), float(frameNo),
+                                   [](float frame, const LOTKeyFrame<T> &keyFrame) {
+                                       return frame < keyFrame.mStartFrame;
+                                   });
+        if (it != mKeyFrames.begin() && contains(*(it - 1))) {
+            mCursor.store(uint32_t(it - 1 - mKeyFrames.begin()), std::memory_order_relaxed);
+            return &*(it - 1);
+        }
+
+        // keyframes are not sorted
+        for (i = 0; i < count; i++) {
+            if (contains(mKeyFrames[i])) {
+                mCursor.store(uint32_t(i), std::memory_order_relaxed);
+                return &mKeyFrames[i];
+            }
+        }
+        return nullptr;
     }
 
     bool changed(int prevFrame, int curFrame) const {
@@ -3135,6 +3258,8 @@ public:
 
 public:
     std::vector<LOTKeyFrame<T>>    mKeyFrames;
+private:
+    mutable std::atomic<uint32_t>  mCursor{0};
 };
 
 template<typename T>
@@ -3422,6 +3547,14 @@ public:
             impl.mData = data;
         }
     }
+    // static transform with already computed matrix
+    void set(VMatrix matrix, float opacity)
+    {
+        setStatic(true);
+        new (&impl.mStaticData) static_data(std::move(matrix), opacity);
+    }
+    // animated data, valid only when transform is not static
+    const TransformData *data() const { return isStatic() ? nullptr : impl.mData; }
     VMatrix matrix(int frameNo, bool autoOrient = false) const
     {
         if (isStatic()) return impl.mStaticData.mMatrix;
@@ -3511,9 +3644,11 @@ struct LOTAsset
     };
     bool isStatic() const {return mStatic;}
     void setStatic(bool value) {mStatic = value;}
-    VBitmap  bitmap() const {return mBitmap;}
-    void loadImageData(std::string data);
-    void loadImagePath(std::string Path);
+    // image is decoded on first call, until then only compressed data is kept
+    VBitmap  bitmap() const;
+    void setImageData(std::string data);
+    void setImagePath(std::string path);
+    size_t imageBytes() const;
     Type                                      mAssetType{Type::Precomp};
     bool                                      mStatic{true};
     std::string                               mRefId; // ref id
@@ -3521,7 +3656,11 @@ struct LOTAsset
     // image asset data
     int                                       mWidth{0};
     int                                       mHeight{0};
-    VBitmap                                   mBitmap;
+    mutable VBitmap                           mBitmap;
+    // compressed image or image file path while image is not decoded
+    mutable std::string                       mImageSource;
+    bool                                      mImageFile{false};
+    mutable std::once_flag                    mImageOnce;
 };
 
 class LottieShapeData
@@ -3584,13 +3723,11 @@ public:
             if(vec.back().mEndFrame <= frameNo)
                 return vec.back().mValue.mEndValue.toPath(path);
 
-            for(const auto &keyFrame : vec) {
-                if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame) {
-                    LottieShapeData::lerp(keyFrame.mValue.mStartValue,
-                                          keyFrame.mValue.mEndValue,
-                                          keyFrame.progress(frameNo),
-                                          path);
-                }
+            if (const auto keyFrame = animation().keyFrameAt(frameNo)) {
+                LottieShapeData::lerp(keyFrame->mValue.mStartValue,
+                                      keyFrame->mValue.mEndValue,
+                                      keyFrame->progress(frameNo),
+                                      path);
             }
         }
     }
@@ -3720,6 +3857,8 @@ public:
 
     std::vector<Marker>     mMarkers;
     VArenaAlloc             mArenaAlloc{2048};
+    // arenas of parser threads when layers and assets were parsed in parallel
+    std::vector<std::unique_ptr<VArenaAlloc>> mPartArenas;
     LOTModelStat            mStats;
 };
 
@@ -3737,6 +3876,8 @@ public:
     size_t frameAtPos(double pos) const {return mRoot->frameAtPos(pos);}
     std::vector<LayerInfo> layerInfoList() const { return mRoot->layerInfoList();}
     const std::vector<Marker> &markers() const { return mRoot->markers();}
+    // estimate of memory which model hold, parsed data has near size as json source
+    size_t memoryUsage() const {return mRoot->mStats.sourceBytes + mRoot->mStats.imageBytes;}
 public:
     std::shared_ptr<LOTCompositionData> mRoot;
 };
@@ -4158,15 +4299,69 @@ public:
     bool                                    mProcessed{false};
 };
 
+// composition header, enough to setup timeline and viewport without model
+struct LOTCompositionInfo
+{
+    VSize  size;
+    long   startFrame{0};
+    long   endFrame{0};
+    float  frameRate{60};
+
+    double duration() const { return frameDuration() / frameRate; }
+    size_t frameAtPos(double pos) const {
+        if (pos < 0) pos = 0;
+        if (pos > 1) pos = 1;
+        return size_t(pos * frameDuration());
+    }
+    size_t totalFrame() const { return endFrame - startFrame; }
+    long frameDuration() const { return endFrame - startFrame - 1; }
+};
+
+// Counters of gray raster summed over all threads
+struct LottieRasterStats {
+    size_t outlines = 0;    // outlines converted
+    size_t bands = 0;       // passes over outlines, each beyond first one of outline decompose it again
+    size_t bandSplits = 0;  // bands split because cell pool was full and could not grow
+    size_t poolGrows = 0;   // times cell pool of a thread was enlarged
+    size_t poolBytes = 0;   // memory held by cell pools now, never reset
+};
+
 class LottieLoader
 {
 public:
     static void configureModelCacheSize(size_t cacheSize);
+    // budget in bytes of decoded images kept while no animation uses them,
+    // images in use are shared by all animations regardless of it
+    static void configureImageCacheSize(size_t cacheSize);
+    // read only top level fr/ip/op/w/h keys of json file, nested objects are
+    // skipped without parsing and reading stops when all keys are found
+    static bool scanInfo(const std::string &filePath, LOTCompositionInfo &info);
+    // max error of precomputed easing tables of models loaded from now on,
+    // 0 (default) disables tables and easing curves are solved on every
+    // evaluation. 1e-5 keeps antialiased edges within a few levels
+    static void configureEasingTable(float maxError);
+    // json sources of at least minBytes get their assets and layers parsed
+    // on up to maxThreads threads, 1 (default) parses on calling thread only
+    // and 0 means hardware concurrency. Files parsed at the same time split
+    // cores between them, so each gets at most cores / parsers threads
+    static void configureParallelParse(size_t minBytes, unsigned maxThreads);
+    // threads which rasterize paths of rendered frames, thread which render
+    // animation counts as one of them, 1 (default) rasterize on rendering
+    // thread only and 0 means hardware concurrency. Must be called before
+    // first render, later calls are ignored with warning
+    static void configureRasterThreads(unsigned threads);
+    // gray raster counters since start or last reset
+    static LottieRasterStats rasterStats(bool reset = false);
+    // parse json file and write its model to precompiled binary (.lotb) file,
+    // load() use it instead of json while json file is not changed
+    static bool convertToBinary(const std::string &filePath, const std::string &binaryPath);
+    static std::string binaryPath(const std::string &filePath);
     bool load(const std::string &filePath, bool cachePolicy);
     bool loadFromData(std::string &&jsonData, const std::string &key,
                       const std::string &resourcePath, bool cachePolicy);
     std::shared_ptr<LOTModel> model();
 private:
+    bool loadBinary(const std::string &binaryPath, const std::string *source);
     std::shared_ptr<LOTModel>    mModel;
 };
 
@@ -4925,11 +5120,34 @@ public:
     */
     static std::shared_ptr<Animation> loadFromFile(const std::string &path, bool cachePolicy=true);
 
+    /**
+    *  @brief Constructs an animation object from file path without parsing it.
+    *         Only composition header (frame rate, frames and size) is scanned,
+    *         model is parsed on first call which need it or by load().
+    *         falls back to loadFromFile() when header can't be scanned.
+    *
+    *  @param[in] path Lottie resource file path
+    *  @param[in] cachePolicy whether to cache or not the model data.
+    *
+    *  @return Animation object, which renders nothing when model parsing fails.
+    *
+    *  @internal
+    */
+    static std::shared_ptr<Animation> loadFromFileLazy(const std::string &path, bool cachePolicy=true);
+
+    /**
+    *  @brief Parse model of lazy loaded animation now, it is safe to call
+    *         from any thread. Does nothing when model is loaded already.
+    *  @return false when model can't be loaded.
+    */
+    bool load();
+
     /**
     *  @brief Constructs an animation object from JSON string data.
     *
     *  @param[in] jsonData The JSON string data.
-    *  @param[in] key the string that will be used to cache the JSON string data.
+    *  @param[in] key the string that will be used to cache the JSON string data,
+    *             when it is empty hash of JSON string data is used.
     *  @param[in] resourcePath the path will be used to search for external resource.
     *  @param[in] cachePolicy whether to cache or not the model data.
     *             use only when need to explicit disabl caching for a
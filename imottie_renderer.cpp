@@ -35,14 +35,53 @@
 #include "imlottie_impl.h"
 
 #include <fstream>
+#include <filesystem>
+#include <list>
 #include <mutex>
 #include <condition_variable>
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// simd paths are picked at compile time, scalar code is used when none fits
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOTTIE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define LOTTIE_AVX2
+#include <immintrin.h>
+#elif defined(LOTTIE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+// avx2 kernels are built for target and picked when cpu supports them
+#define LOTTIE_AVX2_RUNTIME
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LOTTIE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace imlottie {
     std::shared_ptr<Animation> animationLoad(const char *path) {
-        return Animation::loadFromFile(path, false
-                                                /*not use cache*/
-        );
+        // animations of same file with another size, loop or rate share parsed model,
+        // every Animation keep only own render tree
+        // only header is read here, model is parsed on first render
+        return Animation::loadFromFileLazy(path, true);
+    }
+    bool animationPrepare(const std::shared_ptr<Animation> &anim) {
+        return anim->load();
     }
     uint16_t animationTotalFrame(const std::shared_ptr<Animation> &anim) {
         return anim->totalFrame();
@@ -56,6 +95,9 @@ namespace imlottie {
         // structure which not save any data
         anim->renderSync(nextFrameIndex, surface);
     }
+    void configureRasterThreads(unsigned threads) {
+        LottieLoader::configureRasterThreads(threads);
+    }
 } // ImGui
 
 namespace imlottie {
@@ -72,14 +114,22 @@ static void rleOpGeneric(VRleHelper *, VRleHelper *, VRleHelper *, Operation op)
 static void rleSubstractWithRle(VRleHelper *, VRleHelper *, VRleHelper *);
 static inline uchar divBy255(int x) { return (x + (x >> 8) + 0x80) >> 8; }
 inline static void copyArrayToVector(const VRle::Span *span, size_t count, std::vector<VRle::Span> &v) {
-    // make sure enough memory available
-    if (v.capacity() < v.size() + count) v.reserve(v.size() + count);
-    std::copy(span, span + count, std::back_inserter(v));
+    // insert grows capacity geometrically, exact reserve made every append
+    // reallocate whole vector
+    v.insert(v.end(), span, span + count);
 }
 void VRle::VRleData::addSpan(const VRle::Span *span, size_t count) {
     copyArrayToVector                   (span, count, mSpans);
     mBboxDirty                          = true;
 }
+VRle::Span *VRle::VRleData::appendSpans(size_t written, size_t reserve) {
+    mSpans.resize(mSpans.size() - mReserved + written);
+    mReserved = reserve;
+    mBboxDirty = true;
+    if (!reserve) return nullptr;
+    mSpans.resize(mSpans.size() + reserve);
+    return mSpans.data() + mSpans.size() - reserve;
+}
 VRect VRle::VRleData::bbox() const {
     updateBbox();
     return mBbox;
@@ -90,6 +140,7 @@ void VRle::VRleData::setBbox(const VRect &bbox) const {
 }
 void VRle::VRleData::reset() {
     mSpans.clear();
+    mReserved = 0;
     mBbox = VRect();
     mOffset = VPoint();
     mBboxDirty = false;
@@ -876,6 +927,11 @@ static void rleGenerationCb(int count, const SW_FT_Span *spans, void *user) {
     auto *rleSpan = reinterpret_cast<const VRle::Span *>(spans);
     rle->addSpan(rleSpan, count);
 }
+static SW_FT_Span *rleSpanBufferCb(int count, int *capacity, void *user) {
+    VRle *rle = static_cast<VRle *>(user);
+    auto *spans = rle->appendSpans(size_t(count), size_t(*capacity));
+    return reinterpret_cast<SW_FT_Span *>(spans);
+}
 static void bboxCb(int x, int y, int w, int h, void *user) {
     VRle *rle = static_cast<VRle *>(user);
     rle->setBoundingRect( {
@@ -928,6 +984,12 @@ private:
 ;
 struct VRleTask {
     SharedRle mRle;
+    // false while task is queued and nobody started it, worker of scheduler
+    // and thread which need result race for it and winner rasterize path
+    ::std::atomic<bool> mClaimed {
+        true
+    }
+    ;
     VPath     mPath;
     float     mStrokeWidth;
     float     mMiterLimit;
@@ -936,10 +998,23 @@ struct VRleTask {
     CapStyle  mCap;
     JoinStyle mJoin;
     bool      mGenerateStroke;
-    VRle &rle() {
-        return mRle.get();
+    bool claim() {
+        return !mClaimed.exchange(true, ::std::memory_order_acq_rel);
+    }
+    void release() {
+        mClaimed.store(false, ::std::memory_order_release);
+    }
+    // run task on this thread if no worker took it yet, else wait for worker
+    VRle &rle();
+    // pending result is not needed anymore, drop it if nobody started it
+    void finish() {
+        if (claim()) {
+            mPath = VPath();
+            mRle.notify();
+        }
     }
     void update(VPath path, FillRule fillRule, const VRect &clip) {
+        finish();
         mRle.reset();
         mPath = std::move(path);
         mFillRule = fillRule;
@@ -948,6 +1023,7 @@ struct VRleTask {
     }
     void update(VPath path, CapStyle cap, JoinStyle join, float width,
                 float miterLimit, const VRect &clip) {
+        finish();
         mRle.reset();
         mPath = std::move(path);
         mCap = cap;
@@ -962,6 +1038,7 @@ struct VRleTask {
         mRle.unsafe().reset();
         params.flags = SW_FT_RASTER_FLAG_DIRECT | SW_FT_RASTER_FLAG_AA;
         params.gray_spans = &rleGenerationCb;
+        params.span_buffer = &rleSpanBufferCb;
         params.bbox_cb = &bboxCb;
         params.user = &mRle.unsafe();
         params.source = &outRef.ft;
@@ -978,6 +1055,10 @@ struct VRleTask {
     void operator()(FTOutline &outRef, SW_FT_Stroker &stroker) {
         if (mPath.points().size() > SHRT_MAX ||
             mPath.points().size() + mPath.segments() > SHRT_MAX) {
+            // too big for rasterizer, still publish empty rle to waiter
+            mRle.unsafe().reset();
+            mPath = VPath();
+            mRle.notify();
             return;
         }
         if (mGenerateStroke) {
@@ -1012,25 +1093,190 @@ struct VRleTask {
 }
 ;
 using VTask = std::shared_ptr<VRleTask>;
-class RleTaskScheduler {
+// scratch outline and stroker of one rasterization, every thread which
+// rasterize paths keeps own copy
+class RleScratch {
 public:
     FTOutline     outlineRef {
     }
     ;
     SW_FT_Stroker stroker;
+public:
+    static RleScratch &instance() {
+        static thread_local RleScratch scratch;
+        return scratch;
+    }
+    RleScratch() {
+        SW_FT_Stroker_New(&stroker);
+    }
+    ~RleScratch() {
+        SW_FT_Stroker_Done(stroker);
+    }
+    void process(VRleTask &task) {
+        task(outlineRef, stroker);
+    }
+}
+;
+VRle &VRleTask::rle() {
+    if (claim()) RleScratch::instance().process(*this);
+    return mRle.get();
+}
+template <typename Task>
+class TaskQueue {
+    using lock_t = ::std::unique_lock<::std::mutex>;
+    ::std::deque<Task>        _q;
+    bool                    _done {
+        false
+    }
+    ;
+    ::std::mutex              _mutex;
+    ::std::condition_variable _ready;
+public:
+    bool try_pop(Task &task) {
+        lock_t lock {
+            _mutex, ::std::try_to_lock
+        }
+        ;
+        if (!lock || _q.empty()) return false;
+        task = std::move(_q.front());
+        _q.pop_front();
+        return true;
+    }
+    bool try_push(Task &&task) {
+        {
+            lock_t lock {
+                _mutex, ::std::try_to_lock
+            }
+            ;
+            if (!lock) return false;
+            _q.push_back(std::move(task));
+        }
+        _ready.notify_one();
+        return true;
+    }
+    void done() {
+        {
+            lock_t lock {
+                _mutex
+            }
+            ;
+            _done = true;
+        }
+        _ready.notify_all();
+    }
+    bool pop(Task &task) {
+        lock_t lock {
+            _mutex
+        }
+        ;
+        while (_q.empty() && !_done) _ready.wait(lock);
+        if (_q.empty()) return false;
+        task = std::move(_q.front());
+        _q.pop_front();
+        return true;
+    }
+    void push(Task &&task) {
+        {
+            lock_t lock {
+                _mutex
+            }
+            ;
+            _q.push_back(std::move(task));
+        }
+        _ready.notify_one();
+    }
+}
+;
+// animations are usually rendered on several threads already, so paths are
+// rasterized on rendering thread unless more threads are configured
+static ::std::atomic<unsigned> rasterThreadsNum {
+    1
+}
+;
+static ::std::atomic<bool> rasterThreadsStarted {
+    false
+}
+;
+void LottieLoader::configureRasterThreads(unsigned threads) {
+    // pool is already started with previous count, it is not resized
+    assert(!rasterThreadsStarted && "configureRasterThreads() must be called before first render");
+    if (rasterThreadsStarted) {
+        vWarning << "Raster threads are configured after first render, " << threads << " is ignored";
+        return;
+    }
+    rasterThreadsNum = threads;
+}
+LottieRasterStats LottieLoader::rasterStats(bool reset) {
+    SW_FT_Raster_Stats raster;
+    sw_ft_grays_raster_stats(&raster, reset);
+    LottieRasterStats stats;
+    stats.outlines = size_t(raster.renders);
+    stats.bands = size_t(raster.bands);
+    stats.bandSplits = size_t(raster.band_splits);
+    stats.poolGrows = size_t(raster.pool_grows);
+    stats.poolBytes = size_t(raster.pool_bytes);
+    return stats;
+}
+// drawables of layer tree queue their paths here in preprocess() and pick
+// up rle at paint time, so one animation is rasterized by several cores.
+// Workers pop from own queue and steal from others, thread which render
+// animation rasterize still unclaimed tasks itself when it needs their rle
+class RleTaskScheduler {
+    unsigned                          _count;
+    ::std::vector<::std::thread>          _threads;
+    ::std::vector<TaskQueue<VTask>>     _q;
+    ::std::atomic<unsigned>             _index {
+        0
+    }
+    ;
+    void run(unsigned i) {
+        VTask task;
+        while (true) {
+            bool success = false;
+            for (unsigned n = 0; n != _count * 2; ++n) {
+                if (_q[(i + n) % _count].try_pop(task)) {
+                    success = true;
+                    break;
+                }
+            }
+            if (!success && !_q[i].pop(task)) break;
+            if (task->claim()) RleScratch::instance().process(*task);
+            task.reset();
+        }
+    }
+    RleTaskScheduler() {
+        rasterThreadsStarted = true;
+        unsigned threads = rasterThreadsNum;
+        if (!threads) threads = ::std::thread::hardware_concurrency();
+        // calling thread works too, so it takes one of threads
+        _count = threads > 1 ? threads - 1 : 0;
+        _q = ::std::vector<TaskQueue<VTask>>(_count);
+        for (unsigned n = 0; n != _count; ++n) {
+            _threads.emplace_back([this, n] {
+                run(n);
+            }
+            );
+        }
+    }
 public:
     static RleTaskScheduler &instance() {
         static RleTaskScheduler singleton;
         return singleton;
     }
-    RleTaskScheduler() {
-        SW_FT_Stroker_New(&stroker);
-    }
     ~RleTaskScheduler() {
-        SW_FT_Stroker_Done(stroker);
+        for (auto &e : _q) e.done();
+        for (auto &e : _threads) e.join();
     }
     void process(VTask task) {
-        (*task)(outlineRef, stroker);
+        if (!_count) {
+            if (task->claim()) RleScratch::instance().process(*task);
+            return;
+        }
+        auto i = _index++;
+        for (unsigned n = 0; n != _count; ++n) {
+            if (_q[(i + n) % _count].try_push(std::move(task))) return;
+        }
+        _q[i % _count].push(std::move(task));
     }
 }
 ;
@@ -1052,12 +1298,14 @@ void VRasterizer::init() {
     if (!d) d = std::make_shared<VRasterizerImpl>();
 }
 void VRasterizer::updateRequest() {
+    d->task().release();
     VTask taskObj = VTask(d, &d->task());
     RleTaskScheduler::instance().process(std::move(taskObj));
 }
 void VRasterizer::rasterize(VPath path, FillRule fillRule, const VRect &clip) {
     init();
     if (path.empty()) {
+        d->task().finish();
         d->rle().reset();
         return;
     }
@@ -1068,6 +1316,7 @@ void VRasterizer::rasterize(VPath path, CapStyle cap, JoinStyle join,
                             float width, float miterLimit, const VRect &clip) {
     init();
     if (path.empty() || vIsZero(width)) {
+        d->task().finish();
         d->rle().reset();
         return;
     }
@@ -1762,8 +2011,43 @@ float VInterpolator::GetSlope(float aT, float aA1, float aA2) {
 }
 float VInterpolator::value(float aX) const {
     if (mX1 == mY1 && mX2 == mY2) return aX;
+    if (!mTable.empty() && aX >= 0.0f && aX <= 1.0f) {
+        float  pos = aX * float(mTable.size() - 1);
+        size_t i = std::min(size_t(pos), mTable.size() - 2);
+        return mTable[i] + (mTable[i + 1] - mTable[i]) * (pos - float(i));
+    }
+    return solve(aX);
+}
+float VInterpolator::solve(float aX) const {
     return CalcBezier(GetTForX(aX), mY1, mY2);
 }
+bool VInterpolator::buildTable(float maxError) {
+    mTable.clear();
+    if (maxError <= 0.0f || (mX1 == mY1 && mX2 == mY2)) return false;
+
+    // each step halves intervals, new entries are the midpoints which also
+    // tell error of previous table
+    std::vector<float> table{solve(0.0f), solve(1.0f)};
+    std::vector<float> next;
+    for (size_t intervals = 1; intervals < kMaxTableSize; intervals *= 2) {
+        next.resize(2 * intervals + 1);
+        float error = 0.0f;
+        for (size_t i = 0; i < intervals; i++) {
+            float mid = solve((float(i) + 0.5f) / float(intervals));
+            next[2 * i] = table[i];
+            next[2 * i + 1] = mid;
+            error = std::max(error, std::fabs(mid - (table[i] + table[i + 1]) * 0.5f));
+        }
+        next[2 * intervals] = table[intervals];
+        table.swap(next);
+
+        if (error <= maxError && 2 * intervals >= kMinTableSize) {
+            mTable = std::move(table);
+            return true;
+        }
+    }
+    return false;
+}
 float VInterpolator::GetTForX(float aX) const {
     // Find interval where t lies
     float              intervalStart = 0.0;
@@ -1821,6 +2105,193 @@ float VInterpolator::BinarySubdivide(float aX, float aA, float aB) const {
            ++i < SUBDIVISION_MAX_ITERATIONS);
     return currentT;
 }
+// rgba pixels of stb to bgra, premultiplied when alpha is present. Alpha is
+// kept and colors are rounded with divBy255 as in blending code
+static void convertPremulScalar(const uchar *src, uchar *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4) {
+        const int a = src[3];
+        dst[0] = divBy255(src[2] * a);
+        dst[1] = divBy255(src[1] * a);
+        dst[2] = divBy255(src[0] * a);
+        dst[3] = uchar(a);
+    }
+}
+
+static void convertSwapScalar(const uchar *src, uchar *dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += 4, dst += 4) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+        dst[3] = src[3];
+    }
+}
+
+#ifdef LOTTIE_SSE2
+// two pixels in 16 bit words, alpha is multiplied by 255 so it stays same
+static inline __m128i premulSwapWords(__m128i v)
+{
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)),
+                                        _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_or_si128(_mm_and_si128(alpha, _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+                         _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+    __m128i x = _mm_mullo_epi16(v, alpha);
+    x = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)),
+                                     _mm_set1_epi16(0x80)), 8);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 0, 1, 2)),
+                               _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+static void convertPremulSse2(const uchar *src, uchar *dst, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t        i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i));
+        const __m128i lo = premulSwapWords(_mm_unpacklo_epi8(v, zero));
+        const __m128i hi = premulSwapWords(_mm_unpackhi_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4 * i), _mm_packus_epi16(lo, hi));
+    }
+    convertPremulScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+
+static void convertSwapSse2(const uchar *src, uchar *dst, size_t count)
+{
+    const __m128i ga = _mm_set1_epi32(int(0xff00ff00));
+    const __m128i low = _mm_set1_epi32(0xff);
+    size_t        i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i));
+        const __m128i r = _mm_and_si128(v, low);
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 16), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4 * i),
+                         _mm_or_si128(_mm_and_si128(v, ga),
+                                      _mm_or_si128(b, _mm_slli_epi32(r, 16))));
+    }
+    convertSwapScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+#endif
+
+#if defined(LOTTIE_AVX2) || defined(LOTTIE_AVX2_RUNTIME)
+#ifdef LOTTIE_AVX2_RUNTIME
+#define LOTTIE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LOTTIE_TARGET_AVX2
+#endif
+// same as sse2 versions on 8 pixels
+LOTTIE_TARGET_AVX2 static inline __m256i premulSwapWords(__m256i v)
+{
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)),
+                                           _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_or_si256(
+        _mm256_and_si256(alpha, _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1,
+                                                 0, -1, -1, -1, 0, -1, -1, -1)),
+        _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0));
+    __m256i x = _mm256_mullo_epi16(v, alpha);
+    x = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)),
+                                           _mm256_set1_epi16(0x80)), 8);
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 0, 1, 2)),
+                                  _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+LOTTIE_TARGET_AVX2 static void convertPremulAvx2(const uchar *src, uchar *dst, size_t count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t        i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * i));
+        const __m256i lo = premulSwapWords(_mm256_unpacklo_epi8(v, zero));
+        const __m256i hi = premulSwapWords(_mm256_unpackhi_epi8(v, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4 * i), _mm256_packus_epi16(lo, hi));
+    }
+    convertPremulScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+
+LOTTIE_TARGET_AVX2 static void convertSwapAvx2(const uchar *src, uchar *dst, size_t count)
+{
+    const __m256i swap = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t        i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4 * i), _mm256_shuffle_epi8(v, swap));
+    }
+    convertSwapScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+#endif
+
+#ifdef LOTTIE_NEON
+static void convertPremulNeon(const uchar *src, uchar *dst, size_t count)
+{
+    auto mul = [](uint8x16_t c, uint8x16_t a) {
+        const uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+        const uint16x8_t hi = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+        // divBy255, rounding narrow adds 0x80 before shift
+        return vcombine_u8(vrshrn_n_u16(vaddq_u16(lo, vshrq_n_u16(lo, 8)), 8),
+                           vrshrn_n_u16(vaddq_u16(hi, vshrq_n_u16(hi, 8)), 8));
+    };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x4_t in = vld4q_u8(src + 4 * i);
+        uint8x16x4_t       out;
+        out.val[0] = mul(in.val[2], in.val[3]);
+        out.val[1] = mul(in.val[1], in.val[3]);
+        out.val[2] = mul(in.val[0], in.val[3]);
+        out.val[3] = in.val[3];
+        vst4q_u8(dst + 4 * i, out);
+    }
+    convertPremulScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+
+static void convertSwapNeon(const uchar *src, uchar *dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + 4 * i);
+        std::swap(v.val[0], v.val[2]);
+        vst4q_u8(dst + 4 * i, v);
+    }
+    convertSwapScalar(src + 4 * i, dst + 4 * i, count - i);
+}
+#endif
+
+using PixelConvert = void (*)(const uchar *src, uchar *dst, size_t count);
+
+// best kernels for cpu, avx2 is checked at runtime when not enabled for build
+static std::pair<PixelConvert, PixelConvert> pixelConverters()
+{
+    static const std::pair<PixelConvert, PixelConvert> converters = []() {
+        std::pair<PixelConvert, PixelConvert> result{convertPremulScalar, convertSwapScalar};
+#if defined(LOTTIE_AVX2)
+        result = {convertPremulAvx2, convertSwapAvx2};
+#elif defined(LOTTIE_SSE2)
+        result = {convertPremulSse2, convertSwapSse2};
+#ifdef LOTTIE_AVX2_RUNTIME
+        if (__builtin_cpu_supports("avx2")) result = {convertPremulAvx2, convertSwapAvx2};
+#endif
+#elif defined(LOTTIE_NEON)
+        result = {convertPremulNeon, convertSwapNeon};
+#endif
+        return result;
+    }();
+    return converters;
+}
+
+void VImageLoader::Impl::convertToBGRA(const unsigned char *rgba, VBitmap &bitmap,
+                                       bool premultiply)
+{
+    const PixelConvert convert =
+        premultiply ? pixelConverters().first : pixelConverters().second;
+    const size_t width = bitmap.width();
+    if (bitmap.stride() == width * 4) {
+        convert(rgba, bitmap.data(), width * bitmap.height());
+        return;
+    }
+    for (size_t y = 0; y < bitmap.height(); y++)
+        convert(rgba + y * width * 4, bitmap.data() + y * bitmap.stride(), width);
+}
+
 VImageLoader::VImageLoader() : mImpl(std::make_unique<VImageLoader::Impl>()) {
 }
 VImageLoader::~VImageLoader() {
@@ -3283,6 +3754,11 @@ RjInsituStringStream::RjInsituStringStream(char* str)
     ss_ = new rapidjson::InsituStringStream(str);
 }
 
+void RjInsituStringStream::reset(char* str)
+{
+    *(rapidjson::InsituStringStream*)ss_ = rapidjson::InsituStringStream(str);
+}
+
 RjReader::RjReader() { r_ = new rapidjson::Reader(); }
 
 static rapidjson::Reader& rcast(void* p) { return *(rapidjson::Reader*)p; }
@@ -3377,6 +3853,13 @@ public:
 
 protected:
     explicit LookaheadParserHandler(char *str);
+    // start parsing another string with same reader
+    void reset(char *str)
+    {
+        st_ = kInit;
+        ss_.reset(str);
+        r_.IterativeParseInit();
+    }
 
 protected:
     enum LookaheadParsingState {
@@ -3401,14 +3884,65 @@ protected:
     static const int parseFlags = 0 | 1;//kParseDefaultFlags | kParseInsituFlag;
 };
 
+// object key as integer, so parsers switch on it instead of strcmp chains. Keys
+// up to 8 chars are packed exactly, longer keys are hashed with top bit set,
+// which ascii packed key never has. Case labels are evaluated at compile time
+using LottieKey = uint64_t;
+
+constexpr LottieKey lottieKey(const char *key)
+{
+    LottieKey result = 0;
+    size_t    i = 0;
+    for (; i < sizeof(LottieKey) && key[i]; i++)
+        result |= LottieKey(uint8_t(key[i])) << (8 * i);
+    if (!key[i]) return result;
+
+    result = 14695981039346656037ull;
+    for (i = 0; key[i]; i++)
+        result = (result ^ uint8_t(key[i])) * 1099511628211ull;
+    return result | (1ull << 63);
+}
+
+// assets and layers of large json found by structural scan, they are parsed
+// in place on worker threads before the composition. Composition itself is
+// parsed from a copy where their arrays are empty and picks results from here
+struct LottieParts {
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+    Range              assetsArray{0, 0};  // '[' .. past ']'
+    Range              layersArray{0, 0};
+    std::vector<Range> assets;
+    std::vector<Range> layers;
+
+    std::shared_ptr<LOTCompositionData> composition;
+    std::vector<LOTAsset *>             assetData;   // in json order
+    std::vector<LOTLayerData *>         layerData;
+    std::vector<LOTLayerData *>         layersToUpdate;
+    std::atomic<bool>                   valid{true};
+
+    size_t count() const { return assets.size() + layers.size(); }
+    size_t bytes() const
+    {
+        return (assetsArray.end - assetsArray.begin) +
+               (layersArray.end - layersArray.begin);
+    }
+};
+
 class LottieParserImpl : public LookaheadParserHandler {
 public:
     LottieParserImpl(char *str, const char *dir_path)
         : LookaheadParserHandler(str), mDirPath(dir_path) {}
+    // parser of worker thread, objects go to its own arena of composition
+    LottieParserImpl(const char *dir_path, LOTCompositionData *comp,
+                     VArenaAlloc *arena)
+        : LookaheadParserHandler(nullptr), compRef(comp), mDirPath(dir_path),
+          mArena(arena) {}
     bool VerifyType();
     bool ParseNext();
 public:
-    VArenaAlloc& allocator() {return compRef->mArenaAlloc;}
+    VArenaAlloc& allocator() {return mArena ? *mArena : compRef->mArenaAlloc;}
     bool        EnterObject();
     bool        EnterArray();
     const char *NextObjectKey();
@@ -3491,12 +4025,21 @@ public:
     void parseShapeProperty(LOTAnimatable<LottieShapeData> &obj);
     void parseDashProperty(LOTDashProperty &dash);
 
-    VInterpolator* interpolator(VPointF, VPointF, const char*);
+    VInterpolator* interpolator(VPointF, VPointF);
 
     LottieColor toColor(const char *str);
 
     void resolveLayerRefs();
 
+    void setParts(LottieParts *parts) { mParts = parts; }
+    void takeLayersToUpdate(std::vector<LOTLayerData *> &layers)
+    {
+        layers.insert(layers.end(), mLayersToUpdate.begin(), mLayersToUpdate.end());
+        mLayersToUpdate.clear();
+    }
+    // parses parts by index taken from next until all are done
+    void parseParts(char *str, LottieParts &parts, std::atomic<size_t> &next);
+
 protected:
     std::unordered_map<std::string, VInterpolator*>
         mInterpolatorCache;
@@ -3508,6 +4051,8 @@ protected:
     std::vector<VPointF>                       mInPoint;  /* "i" */
     std::vector<VPointF>                       mOutPoint; /* "o" */
     std::vector<VPointF>                       mVertices;
+    VArenaAlloc *                              mArena{nullptr};
+    LottieParts *                              mParts{nullptr};
     void                                       SkipOut(int depth);
 };
 
@@ -3771,6 +4316,10 @@ LottieBlendMode LottieParserImpl::getBlendMode()
 
 void LottieParserImpl::resolveLayerRefs()
 {
+    if (mParts)
+        mLayersToUpdate.insert(mLayersToUpdate.end(),
+                               mParts->layersToUpdate.begin(),
+                               mParts->layersToUpdate.end());
     for (const auto &layer : mLayersToUpdate) {
         auto          search = compRef->mAssets.find(layer->extra()->mPreCompRefId.c_str());
         if (search != compRef->mAssets.end()) {
@@ -3790,39 +4339,50 @@ void LottieParserImpl::parseComposition()
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
     EnterObject();
     std::shared_ptr<LOTCompositionData> sharedComposition =
-        std::make_shared<LOTCompositionData>();
+        mParts ? mParts->composition : std::make_shared<LOTCompositionData>();
     LOTCompositionData *comp = sharedComposition.get();
     compRef = comp;
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "v")) {
+        switch (lottieKey(key)) {
+        case lottieKey("v"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
             comp->mVersion = std::string(GetString());
-        } else if (0 == strcmp(key, "w")) {
+            break;
+        case lottieKey("w"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             comp->mSize.setWidth(GetInt());
-        } else if (0 == strcmp(key, "h")) {
+            break;
+        case lottieKey("h"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             comp->mSize.setHeight(GetInt());
-        } else if (0 == strcmp(key, "ip")) {
+            break;
+        case lottieKey("ip"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             comp->mStartFrame = (long)GetDouble();
-        } else if (0 == strcmp(key, "op")) {
+            break;
+        case lottieKey("op"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             comp->mEndFrame = (long)GetDouble();
-        } else if (0 == strcmp(key, "fr")) {
+            break;
+        case lottieKey("fr"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             comp->mFrameRate = (float)GetDouble();
-        } else if (0 == strcmp(key, "assets")) {
+            break;
+        case lottieKey("assets"):
             parseAssets(comp);
-        } else if (0 == strcmp(key, "layers")) {
+            break;
+        case lottieKey("layers"):
             parseLayers(comp);
-        } else if (0 == strcmp(key, "markers")) {
+            break;
+        case lottieKey("markers"):
             parseMarkers();
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Composition Attribute Skipped : " << key;
 #endif
             Skip(key);
+            break;
         }
     }
 
@@ -3830,7 +4390,7 @@ void LottieParserImpl::parseComposition()
         // don't have a valid bodymovin header
         return;
     }
-    if (!IsValid()) {
+    if (!IsValid() || (mParts && !mParts->valid)) {
         return;
     }
 
@@ -3850,21 +4410,26 @@ void LottieParserImpl::parseMarker()
     int         timeframe{0};
     int          duration{0};
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "cm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("cm"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
             comment = std::string(GetString());
-        } else if (0 == strcmp(key, "tm")) {
+            break;
+        case lottieKey("tm"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             timeframe = (int)GetDouble();
-        } else if (0 == strcmp(key, "dr")) {
+            break;
+        case lottieKey("dr"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             duration = (int)GetDouble();
 
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Marker Attribute Skipped : " << key;
 #endif
             Skip(key);
+            break;
         }
     }
     compRef->mMarkers.emplace_back(std::move(comment), timeframe, timeframe + duration);
@@ -3888,6 +4453,10 @@ void LottieParserImpl::parseAssets(LOTCompositionData *composition)
         auto asset = parseAsset();
         composition->mAssets[asset->mRefId.c_str()] = asset;
     }
+    if (mParts) {
+        for (auto asset : mParts->assetData)
+            if (asset) composition->mAssets[asset->mRefId.c_str()] = asset;
+    }
     // update the precomp layers with the actual layer object
 }
 
@@ -3900,6 +4469,157 @@ static constexpr const unsigned char B64index[256] = {
     25, 0,  0,  0,  0,  63, 0,  26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
     37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51};
 
+#ifdef LOTTIE_SSE2
+// maps standard base64 chars to 6 bit values, valid gets all bits set for
+// them. Other chars are left to scalar decoder, which maps url safe ones
+static inline __m128i b64translate(__m128i c, __m128i &valid)
+{
+    auto range = [c](char first, char last) {
+        return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(first - 1)),
+                             _mm_cmpgt_epi8(_mm_set1_epi8(last + 1), c));
+    };
+    const __m128i upper = range('A', 'Z');
+    const __m128i lower = range('a', 'z');
+    const __m128i digit = range('0', '9');
+    const __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+    valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                         _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    const __m128i offset = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(_mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                                  _mm_and_si128(plus, _mm_set1_epi8(62 - '+'))),
+                     _mm_and_si128(slash, _mm_set1_epi8(63 - '/'))));
+    return _mm_add_epi8(c, offset);
+}
+
+// each 32 bit lane holds 4 values of one group, result has their 3 bytes in
+// low 24 bits of lane in memory order
+static inline __m128i b64pack(__m128i v)
+{
+    const __m128i byte = _mm_set1_epi32(0xff);
+    const __m128i a = _mm_and_si128(v, byte);
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 8), byte);
+    const __m128i c = _mm_and_si128(_mm_srli_epi32(v, 16), byte);
+    const __m128i d = _mm_srli_epi32(v, 24);
+    const __m128i first = _mm_or_si128(_mm_slli_epi32(a, 2), _mm_srli_epi32(b, 4));
+    const __m128i second = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(b, _mm_set1_epi32(0xf)), 12),
+                                        _mm_slli_epi32(_mm_srli_epi32(c, 2), 8));
+    const __m128i third = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(3)), 22),
+                                       _mm_slli_epi32(d, 16));
+    return _mm_or_si128(_mm_or_si128(first, second), third);
+}
+#endif
+
+#ifdef LOTTIE_AVX2
+// same as sse2 versions on 32 chars
+static inline __m256i b64translate(__m256i c, __m256i &valid)
+{
+    auto range = [c](char first, char last) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8(first - 1)),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), c));
+    };
+    const __m256i upper = range('A', 'Z');
+    const __m256i lower = range('a', 'z');
+    const __m256i digit = range('0', '9');
+    const __m256i plus = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('+'));
+    const __m256i slash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/'));
+    valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                            _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+    const __m256i offset = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                        _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+        _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                                        _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+'))),
+                        _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/'))));
+    return _mm256_add_epi8(c, offset);
+}
+
+static inline __m256i b64pack(__m256i v)
+{
+    const __m256i byte = _mm256_set1_epi32(0xff);
+    const __m256i a = _mm256_and_si256(v, byte);
+    const __m256i b = _mm256_and_si256(_mm256_srli_epi32(v, 8), byte);
+    const __m256i c = _mm256_and_si256(_mm256_srli_epi32(v, 16), byte);
+    const __m256i d = _mm256_srli_epi32(v, 24);
+    const __m256i first = _mm256_or_si256(_mm256_slli_epi32(a, 2), _mm256_srli_epi32(b, 4));
+    const __m256i second = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(b, _mm256_set1_epi32(0xf)), 12),
+                                           _mm256_slli_epi32(_mm256_srli_epi32(c, 2), 8));
+    const __m256i third = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(3)), 22),
+                                          _mm256_slli_epi32(d, 16));
+    return _mm256_or_si256(_mm256_or_si256(first, second), third);
+}
+#endif
+
+// decodes groups of standard base64 chars with simd, returns number of chars
+// done. It stops before block with any other char, scalar code goes on there
+static size_t b64decodeBlocks(const unsigned char *src, size_t len, char *dst)
+{
+    size_t i = 0;
+#ifdef LOTTIE_AVX2
+    // lanes are stored by 4 bytes, last one writes a byte of next group
+    for (; i + 36 <= len; i += 32) {
+        __m256i valid;
+        const __m256i v = b64translate(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), valid);
+        if (uint32_t(_mm256_movemask_epi8(valid)) != 0xffffffffu) return i;
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), b64pack(v));
+        char *out = dst + i / 4 * 3;
+        for (int k = 0; k < 8; k++) memcpy(out + 3 * k, lanes + k, 4);
+    }
+#endif
+#ifdef LOTTIE_SSE2
+    for (; i + 20 <= len; i += 16) {
+        __m128i valid;
+        const __m128i v = b64translate(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), valid);
+        if (_mm_movemask_epi8(valid) != 0xffff) return i;
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), b64pack(v));
+        char *out = dst + i / 4 * 3;
+        for (int k = 0; k < 4; k++) memcpy(out + 3 * k, lanes + k, 4);
+    }
+#endif
+#ifdef LOTTIE_NEON
+    auto translate = [](uint8x16_t c, uint8x16_t &valid) {
+        const uint8x16_t upper = vandq_u8(vcgeq_u8(c, vdupq_n_u8('A')), vcleq_u8(c, vdupq_n_u8('Z')));
+        const uint8x16_t lower = vandq_u8(vcgeq_u8(c, vdupq_n_u8('a')), vcleq_u8(c, vdupq_n_u8('z')));
+        const uint8x16_t digit = vandq_u8(vcgeq_u8(c, vdupq_n_u8('0')), vcleq_u8(c, vdupq_n_u8('9')));
+        const uint8x16_t plus = vceqq_u8(c, vdupq_n_u8('+'));
+        const uint8x16_t slash = vceqq_u8(c, vdupq_n_u8('/'));
+        valid = vandq_u8(valid, vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(vorrq_u8(digit, plus), slash)));
+        const uint8x16_t offset = vorrq_u8(
+            vorrq_u8(vandq_u8(upper, vdupq_n_u8(uint8_t(-'A'))),
+                     vandq_u8(lower, vdupq_n_u8(uint8_t(26 - 'a')))),
+            vorrq_u8(vorrq_u8(vandq_u8(digit, vdupq_n_u8(uint8_t(52 - '0'))),
+                              vandq_u8(plus, vdupq_n_u8(uint8_t(62 - '+')))),
+                     vandq_u8(slash, vdupq_n_u8(uint8_t(63 - '/')))));
+        return vaddq_u8(c, offset);
+    };
+    // groups are split to 4 registers by their char positions
+    for (; i + 64 <= len; i += 64) {
+        uint8x16x4_t in = vld4q_u8(src + i);
+        uint8x16_t   valid = vdupq_n_u8(0xff);
+        const uint8x16_t a = translate(in.val[0], valid);
+        const uint8x16_t b = translate(in.val[1], valid);
+        const uint8x16_t c = translate(in.val[2], valid);
+        const uint8x16_t d = translate(in.val[3], valid);
+        const uint64x2_t all = vreinterpretq_u64_u8(valid);
+        if ((vgetq_lane_u64(all, 0) & vgetq_lane_u64(all, 1)) != ~uint64_t(0)) return i;
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(reinterpret_cast<uint8_t *>(dst + i / 4 * 3), out);
+    }
+#endif
+    (void)src;
+    (void)dst;
+    return i - i % 4;
+}
+
 std::string b64decode(const char *data, const size_t len)
 {
     auto p = reinterpret_cast<const unsigned char *>(data);
@@ -3907,7 +4627,8 @@ std::string b64decode(const char *data, const size_t len)
     const size_t   L = ((len + 3) / 4 - pad) * 4;
     std::string    str(L / 4 * 3 + pad, '\0');
 
-    for (size_t i = 0, j = 0; i < L; i += 4) {
+    const size_t done = b64decodeBlocks(p, L, &str[0]);
+    for (size_t i = done, j = done / 4 * 3; i < L; i += 4) {
         int n = B64index[p[i]] << 18 | B64index[p[i + 1]] << 12 |
             B64index[p[i + 2]] << 6 | B64index[p[i + 3]];
         str[j++] = char(n >> 16);
@@ -3926,17 +4647,14 @@ std::string b64decode(const char *data, const size_t len)
     return str;
 }
 
-static std::string convertFromBase64(const std::string &str)
+static std::string convertFromBase64(const char *str)
 {
     // usual header look like "data:image/png;base64,"
     // so need to skip till ','.
-    size_t startIndex = str.find(",", 0);
-    startIndex += 1;  // skip ","
-    size_t length = str.length() - startIndex;
+    const char *comma = strchr(str, ',');
+    const char *b64Data = comma ? comma + 1 : str;
 
-    const char *b64Data = str.c_str() + startIndex;
-
-    return b64decode(b64Data, length);
+    return b64decode(b64Data, strlen(b64Data));
 }
 
 /*
@@ -3958,34 +4676,42 @@ LOTAsset* LottieParserImpl::parseAsset()
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
 
     auto                      asset = allocator().make<LOTAsset>();
-    std::string               filename;
+    // points to json buffer, embedded images are not copied before decoding
+    const char               *filename = "";
     std::string               relativePath;
     bool                      embededResource = false;
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "w")) {
+        switch (lottieKey(key)) {
+        case lottieKey("w"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             asset->mWidth = GetInt();
-        } else if (0 == strcmp(key, "h")) {
+            break;
+        case lottieKey("h"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             asset->mHeight = GetInt();
-        } else if (0 == strcmp(key, "p")) { /* image name */
+            break;
+        case lottieKey("p"): /* image name */
             asset->mAssetType = LOTAsset::Type::Image;
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
-            filename = std::string(GetString());
-        } else if (0 == strcmp(key, "u")) { /* relative image path */
+            filename = GetString();
+            break;
+        case lottieKey("u"): /* relative image path */
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
             relativePath = std::string(GetString());
-        } else if (0 == strcmp(key, "e")) { /* relative image path */
+            break;
+        case lottieKey("e"): /* relative image path */
             embededResource = GetInt();
-        } else if (0 == strcmp(key, "id")) { /* reference id*/
+            break;
+        case lottieKey("id"): /* reference id*/
             if (PeekType() == rapidjson::kStringType) {
                 asset->mRefId = std::string(GetString());
             } else {
                 RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
                 asset->mRefId = toString(GetInt()).c_str();
             }
-        } else if (0 == strcmp(key, "layers")) {
+            break;
+        case lottieKey("layers"): {
             asset->mAssetType = LOTAsset::Type::Precomp;
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kArrayType);
             EnterArray();
@@ -3998,22 +4724,25 @@ LOTAsset* LottieParserImpl::parseAsset()
                 }
             }
             asset->setStatic(staticFlag);
-        } else {
+            break;
+        }
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Asset Attribute Skipped : " << key;
 #endif
             Skip(key);
+            break;
         }
     }
 
     if (asset->mAssetType == LOTAsset::Type::Image) {
         if (embededResource) {
             // embeder resource should start with "data:"
-            if (filename.compare(0, 5, "data:") == 0) {
-                asset->loadImageData(convertFromBase64(filename));
+            if (strncmp(filename, "data:", 5) == 0) {
+                asset->setImageData(convertFromBase64(filename));
             }
         } else {
-            asset->loadImagePath(mDirPath + relativePath + filename);
+            asset->setImagePath(mDirPath + relativePath + filename);
         }
     }
 
@@ -4035,9 +4764,36 @@ void LottieParserImpl::parseLayers(LOTCompositionData *comp)
             comp->mRootLayer->mChildren.push_back(layer);
         }
     }
+    if (mParts) {
+        for (auto layer : mParts->layerData) {
+            if (!layer) continue;
+            staticFlag = staticFlag && layer->isStatic();
+            comp->mRootLayer->mChildren.push_back(layer);
+        }
+    }
     comp->mRootLayer->setStatic(staticFlag);
 }
 
+void LottieParserImpl::parseParts(char *str, LottieParts &parts,
+                                  std::atomic<size_t> &next)
+{
+    const size_t assetCount = parts.assets.size();
+    for (size_t i = next++; i < parts.count() && parts.valid; i = next++) {
+        const bool   asset = i < assetCount;
+        const size_t index = asset ? i : i - assetCount;
+        reset(str + (asset ? parts.assets[index] : parts.layers[index]).begin);
+        if (!ParseNext()) {
+            parts.valid = false;
+            break;
+        }
+        if (asset)
+            parts.assetData[index] = parseAsset();
+        else
+            parts.layerData[index] = parseLayer();
+        if (!IsValid()) parts.valid = false;
+    }
+}
+
 LottieColor LottieParserImpl::toColor(const char *str)
 {
     LottieColor color;
@@ -4125,75 +4881,99 @@ LOTLayerData* LottieParserImpl::parseLayer()
     bool ddd = true;
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "ty")) { /* Type of layer*/
+        switch (lottieKey(key)) {
+        case lottieKey("ty"): /* Type of layer*/
             layer->mLayerType = getLayerType();
-        } else if (0 == strcmp(key, "nm")) { /*Layer name*/
+            break;
+        case lottieKey("nm"): /*Layer name*/
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
             layer->setName(GetString());
-        } else if (0 == strcmp(key, "ind")) { /*Layer index in AE. Used for
+            break;
+        case lottieKey("ind"): /*Layer index in AE. Used for
                                               parenting and expressions.*/
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mId = GetInt();
-        } else if (0 == strcmp(key, "ddd")) { /*3d layer */
+            break;
+        case lottieKey("ddd"): /*3d layer */
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             ddd = GetInt();
-        } else if (0 ==
-                   strcmp(key,
-                   "parent")) { /*Layer Parent. Uses "ind" of parent.*/
+            break;
+        case lottieKey("parent"): /*Layer Parent. Uses "ind" of parent.*/
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mParentId = GetInt();
-        } else if (0 == strcmp(key, "refId")) { /*preComp Layer reference id*/
+            break;
+        case lottieKey("refId"): /*preComp Layer reference id*/
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
             layer->extra()->mPreCompRefId = std::string(GetString());
             layer->mHasGradient = true;
             mLayersToUpdate.push_back(layer);
-        } else if (0 == strcmp(key, "sr")) {  // "Layer Time Stretching"
+            break;
+        case lottieKey("sr"): // "Layer Time Stretching"
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mTimeStreatch = (float)GetDouble();
-        } else if (0 == strcmp(key, "tm")) {  // time remapping
+            break;
+        case lottieKey("tm"): // time remapping
             parseProperty(layer->extra()->mTimeRemap);
-        } else if (0 == strcmp(key, "ip")) {
+            break;
+        case lottieKey("ip"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mInFrame = std::lround((float)GetDouble());
-        } else if (0 == strcmp(key, "op")) {
+            break;
+        case lottieKey("op"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mOutFrame = std::lround((float)GetDouble());
-        } else if (0 == strcmp(key, "st")) {
+            break;
+        case lottieKey("st"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             layer->mStartFrame = (int)GetDouble();
-        } else if (0 == strcmp(key, "bm")) {
+            break;
+        case lottieKey("bm"):
             layer->mBlendMode = getBlendMode();
-        } else if (0 == strcmp(key, "ks")) {
+            break;
+        case lottieKey("ks"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
             EnterObject();
             layer->mTransform = parseTransformObject(ddd);
-        } else if (0 == strcmp(key, "shapes")) {
+            break;
+        case lottieKey("shapes"):
             parseShapesAttr(layer);
-        } else if (0 == strcmp(key, "w")) {
+            break;
+        case lottieKey("w"):
             layer->mLayerSize.setWidth(GetInt());
-        } else if (0 == strcmp(key, "h")) {
+            break;
+        case lottieKey("h"):
             layer->mLayerSize.setHeight(GetInt());
-        } else if (0 == strcmp(key, "sw")) {
+            break;
+        case lottieKey("sw"):
             layer->mLayerSize.setWidth(GetInt());
-        } else if (0 == strcmp(key, "sh")) {
+            break;
+        case lottieKey("sh"):
             layer->mLayerSize.setHeight(GetInt());
-        } else if (0 == strcmp(key, "sc")) {
+            break;
+        case lottieKey("sc"):
             layer->extra()->mSolidColor = toColor(GetString());
-        } else if (0 == strcmp(key, "tt")) {
+            break;
+        case lottieKey("tt"):
             layer->mMatteType = getMatteType();
-        } else if (0 == strcmp(key, "hasMask")) {
+            break;
+        case lottieKey("hasMask"):
             layer->mHasMask = GetBool();
-        } else if (0 == strcmp(key, "masksProperties")) {
+            break;
+        case lottieKey("masksProperties"):
             parseMaskProperty(layer);
-        } else if (0 == strcmp(key, "ao")) {
+            break;
+        case lottieKey("ao"):
             layer->mAutoOrient = GetInt();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             layer->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Layer Attribute Skipped : " << key;
 #endif
             Skip(key);
+            break;
         }
     }
 
@@ -4250,9 +5030,11 @@ LOTMaskData* LottieParserImpl::parseMaskObject()
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "inv")) {
+        switch (lottieKey(key)) {
+        case lottieKey("inv"):
             obj->mInv = GetBool();
-        } else if (0 == strcmp(key, "mode")) {
+            break;
+        case lottieKey("mode"): {
             const char *str = GetString();
             if (!str) {
                 obj->mMode = LOTMaskData::Mode::None;
@@ -4278,12 +5060,17 @@ LOTMaskData* LottieParserImpl::parseMaskObject()
             obj->mMode = LOTMaskData::Mode::None;
             break;
             }
-        } else if (0 == strcmp(key, "pt")) {
+            break;
+        }
+        case lottieKey("pt"):
             parseShapeProperty(obj->mShape);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             parseProperty(obj->mOpacity);
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
     obj->mIsStatic = obj->mShape.isStatic() && obj->mOpacity.isStatic();
@@ -4303,38 +5090,39 @@ LOTData* LottieParserImpl::parseObjectTypeAttr()
 {
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
     const char *type = GetString();
-    if (0 == strcmp(type, "gr")) {
+    switch (lottieKey(type)) {
+    case lottieKey("gr"):
         return parseGroupObject();
-    } else if (0 == strcmp(type, "rc")) {
+    case lottieKey("rc"):
         return parseRectObject();
-    } else if (0 == strcmp(type, "el")) {
+    case lottieKey("el"):
         return parseEllipseObject();
-    } else if (0 == strcmp(type, "tr")) {
+    case lottieKey("tr"):
         return parseTransformObject();
-    } else if (0 == strcmp(type, "fl")) {
+    case lottieKey("fl"):
         return parseFillObject();
-    } else if (0 == strcmp(type, "st")) {
+    case lottieKey("st"):
         return parseStrokeObject();
-    } else if (0 == strcmp(type, "gf")) {
+    case lottieKey("gf"):
         curLayerRef->mHasGradient = true;
         return parseGFillObject();
-    } else if (0 == strcmp(type, "gs")) {
+    case lottieKey("gs"):
         curLayerRef->mHasGradient = true;
         return parseGStrokeObject();
-    } else if (0 == strcmp(type, "sh")) {
+    case lottieKey("sh"):
         return parseShapeObject();
-    } else if (0 == strcmp(type, "sr")) {
+    case lottieKey("sr"):
         return parsePolystarObject();
-    } else if (0 == strcmp(type, "tm")) {
+    case lottieKey("tm"):
         curLayerRef->mHasPathOperator = true;
         return parseTrimObject();
-    } else if (0 == strcmp(type, "rp")) {
+    case lottieKey("rp"):
         curLayerRef->mHasRepeater = true;
         return parseReapeaterObject();
-    } else if (0 == strcmp(type, "mm")) {
+    case lottieKey("mm"):
         vWarning << "Merge Path is not supported yet";
         return nullptr;
-    } else {
+    default:
 #ifdef DEBUG_PARSER
         vDebug << "The Object Type not yet handled = " << type;
 #endif
@@ -4347,11 +5135,15 @@ void LottieParserImpl::parseObject(LOTGroupData *parent)
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "ty")) {
+        switch (lottieKey(key)) {
+        case lottieKey("ty"): {
             auto child = parseObjectTypeAttr();
             if (child && !child->hidden()) parent->mChildren.push_back(child);
-        } else {
+            break;
+        }
+        default:
             Skip(key);
+            break;
         }
     }
 }
@@ -4361,9 +5153,11 @@ LOTData* LottieParserImpl::parseGroupObject()
     auto group = allocator().make<LOTShapeGroupData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             group->setName(GetString());
-        } else if (0 == strcmp(key, "it")) {
+            break;
+        case lottieKey("it"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kArrayType);
             EnterArray();
             while (NextArrayValue()) {
@@ -4374,8 +5168,10 @@ LOTData* LottieParserImpl::parseGroupObject()
                 group->mTransform = static_cast<LOTTransformData *>(group->mChildren.back());
                 group->mChildren.pop_back();
             }
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
     bool staticFlag = true;
@@ -4398,20 +5194,28 @@ LOTRectData* LottieParserImpl::parseRectObject()
     auto obj = allocator().make<LOTRectData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "p")) {
+            break;
+        case lottieKey("p"):
             parseProperty(obj->mPos);
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parseProperty(obj->mSize);
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        case lottieKey("r"):
             parseProperty(obj->mRound);
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        case lottieKey("d"):
             obj->mDirection = GetInt();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mPos.isStatic() && obj->mSize.isStatic() &&
@@ -4427,18 +5231,25 @@ LOTEllipseData* LottieParserImpl::parseEllipseObject()
     auto obj = allocator().make<LOTEllipseData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "p")) {
+            break;
+        case lottieKey("p"):
             parseProperty(obj->mPos);
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parseProperty(obj->mSize);
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        case lottieKey("d"):
             obj->mDirection = GetInt();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mPos.isStatic() && obj->mSize.isStatic());
@@ -4453,19 +5264,25 @@ LOTShapeData* LottieParserImpl::parseShapeObject()
     auto obj = allocator().make<LOTShapeData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "ks")) {
+            break;
+        case lottieKey("ks"):
             parseShapeProperty(obj->mShape);
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        case lottieKey("d"):
             obj->mDirection = GetInt();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vDebug << "Shape property ignored :" << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mShape.isStatic());
@@ -4481,35 +5298,49 @@ LOTPolystarData* LottieParserImpl::parsePolystarObject()
     auto obj = allocator().make<LOTPolystarData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "p")) {
+            break;
+        case lottieKey("p"):
             parseProperty(obj->mPos);
-        } else if (0 == strcmp(key, "pt")) {
+            break;
+        case lottieKey("pt"):
             parseProperty(obj->mPointCount);
-        } else if (0 == strcmp(key, "ir")) {
+            break;
+        case lottieKey("ir"):
             parseProperty(obj->mInnerRadius);
-        } else if (0 == strcmp(key, "is")) {
+            break;
+        case lottieKey("is"):
             parseProperty(obj->mInnerRoundness);
-        } else if (0 == strcmp(key, "or")) {
+            break;
+        case lottieKey("or"):
             parseProperty(obj->mOuterRadius);
-        } else if (0 == strcmp(key, "os")) {
+            break;
+        case lottieKey("os"):
             parseProperty(obj->mOuterRoundness);
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        case lottieKey("r"):
             parseProperty(obj->mRotation);
-        } else if (0 == strcmp(key, "sy")) {
+            break;
+        case lottieKey("sy"): {
             int starType = GetInt();
             if (starType == 1) obj->mPolyType = LOTPolystarData::PolyType::Star;
             if (starType == 2) obj->mPolyType = LOTPolystarData::PolyType::Polygon;
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        }
+        case lottieKey("d"):
             obj->mDirection = GetInt();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vDebug << "Polystar property ignored :" << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(
@@ -4546,23 +5377,31 @@ LOTTrimData* LottieParserImpl::parseTrimObject()
     auto obj = allocator().make<LOTTrimData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parseProperty(obj->mStart);
-        } else if (0 == strcmp(key, "e")) {
+            break;
+        case lottieKey("e"):
             parseProperty(obj->mEnd);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             parseProperty(obj->mOffset);
-        } else if (0 == strcmp(key, "m")) {
+            break;
+        case lottieKey("m"):
             obj->mTrimType = getTrimType();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vDebug << "Trim property ignored :" << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mStart.isStatic() && obj->mEnd.isStatic() &&
@@ -4575,20 +5414,28 @@ void LottieParserImpl::getValue(LOTRepeaterTransform &obj)
     EnterObject();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "a")) {
+        switch (lottieKey(key)) {
+        case lottieKey("a"):
             parseProperty(obj.mAnchor);
-        } else if (0 == strcmp(key, "p")) {
+            break;
+        case lottieKey("p"):
             parseProperty(obj.mPosition);
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        case lottieKey("r"):
             parseProperty(obj.mRotation);
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parseProperty(obj.mScale);
-        } else if (0 == strcmp(key, "so")) {
+            break;
+        case lottieKey("so"):
             parseProperty(obj.mStartOpacity);
-        } else if (0 == strcmp(key, "eo")) {
+            break;
+        case lottieKey("eo"):
             parseProperty(obj.mEndOpacity);
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
 }
@@ -4600,9 +5447,11 @@ LOTRepeaterData* LottieParserImpl::parseReapeaterObject()
     obj->setContent(allocator().make<LOTShapeGroupData>());
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "c")) {
+            break;
+        case lottieKey("c"): {
             parseProperty(obj->mCopies);
             float maxCopy = 0.0;
             if (!obj->mCopies.isStatic()) {
@@ -4616,17 +5465,23 @@ LOTRepeaterData* LottieParserImpl::parseReapeaterObject()
                 maxCopy = obj->mCopies.value();
             }
             obj->mMaxCopies = maxCopy;
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        }
+        case lottieKey("o"):
             parseProperty(obj->mOffset);
-        } else if (0 == strcmp(key, "tr")) {
+            break;
+        case lottieKey("tr"):
             getValue(obj->mTransform);
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vDebug << "Repeater property ignored :" << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mCopies.isStatic() && obj->mOffset.isStatic() &&
@@ -4653,44 +5508,58 @@ LOTTransformData* LottieParserImpl::parseTransformObject(
     }
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             sharedTransform->setName(GetString());
-        } else if (0 == strcmp(key, "a")) {
+            break;
+        case lottieKey("a"):
             parseProperty(obj->mAnchor);
-        } else if (0 == strcmp(key, "p")) {
+            break;
+        case lottieKey("p"): {
             EnterObject();
             bool separate = false;
             while (const char *rkey = NextObjectKey()) {
-                if (0 == strcmp(rkey, "k")) {
+                const LottieKey positionKey = lottieKey(rkey);
+                if (positionKey == lottieKey("k")) {
                     parsePropertyHelper(obj->mPosition);
-                } else if (0 == strcmp(rkey, "s")) {
+                } else if (positionKey == lottieKey("s")) {
                     obj->createExtraData();
                     obj->mExtra->mSeparate = GetBool();
                     separate = true;
-                } else if (separate && (0 == strcmp(rkey, "x"))) {
+                } else if (separate && positionKey == lottieKey("x")) {
                     parseProperty(obj->mExtra->mSeparateX);
-                } else if (separate && (0 == strcmp(rkey, "y"))) {
+                } else if (separate && positionKey == lottieKey("y")) {
                     parseProperty(obj->mExtra->mSeparateY);
                 } else {
                     Skip(rkey);
                 }
             }
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        }
+        case lottieKey("r"):
             parseProperty(obj->mRotation);
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parseProperty(obj->mScale);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             parseProperty(obj->mOpacity);
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             sharedTransform->setHidden(GetBool());
-        } else if (0 == strcmp(key, "rx")) {
+            break;
+        case lottieKey("rx"):
             parseProperty(obj->mExtra->m3DRx);
-        } else if (0 == strcmp(key, "ry")) {
+            break;
+        case lottieKey("ry"):
             parseProperty(obj->mExtra->m3DRy);
-        } else if (0 == strcmp(key, "rz")) {
+            break;
+        case lottieKey("rz"):
             parseProperty(obj->mExtra->m3DRz);
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
     bool isStatic = obj->mAnchor.isStatic() && obj->mPosition.isStatic() &&
@@ -4718,23 +5587,31 @@ LOTFillData* LottieParserImpl::parseFillObject()
     auto obj = allocator().make<LOTFillData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "c")) {
+            break;
+        case lottieKey("c"):
             parseProperty(obj->mColor);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             parseProperty(obj->mOpacity);
-        } else if (0 == strcmp(key, "fillEnabled")) {
+            break;
+        case lottieKey("fillEnabled"):
             obj->mEnabled = GetBool();
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        case lottieKey("r"):
             obj->mFillRule = getFillRule();
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Fill property skipped = " << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mColor.isStatic() && obj->mOpacity.isStatic());
@@ -4804,32 +5681,44 @@ LOTStrokeData* LottieParserImpl::parseStrokeObject()
     auto obj = allocator().make<LOTStrokeData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "c")) {
+            break;
+        case lottieKey("c"):
             parseProperty(obj->mColor);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             parseProperty(obj->mOpacity);
-        } else if (0 == strcmp(key, "w")) {
+            break;
+        case lottieKey("w"):
             parseProperty(obj->mWidth);
-        } else if (0 == strcmp(key, "fillEnabled")) {
+            break;
+        case lottieKey("fillEnabled"):
             obj->mEnabled = GetBool();
-        } else if (0 == strcmp(key, "lc")) {
+            break;
+        case lottieKey("lc"):
             obj->mCapStyle = getLineCap();
-        } else if (0 == strcmp(key, "lj")) {
+            break;
+        case lottieKey("lj"):
             obj->mJoinStyle = getLineJoin();
-        } else if (0 == strcmp(key, "ml")) {
+            break;
+        case lottieKey("ml"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             obj->mMiterLimit = (float)GetDouble();
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        case lottieKey("d"):
             parseDashProperty(obj->mDash);
-        } else if (0 == strcmp(key, "hd")) {
+            break;
+        case lottieKey("hd"):
             obj->setHidden(GetBool());
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vWarning << "Stroke property skipped = " << key;
 #endif
             Skip(key);
+            break;
         }
     }
     obj->setStatic(obj->mColor.isStatic() && obj->mOpacity.isStatic() &&
@@ -4839,37 +5728,51 @@ LOTStrokeData* LottieParserImpl::parseStrokeObject()
 
 void LottieParserImpl::parseGradientProperty(LOTGradient *obj, const char *key)
 {
-    if (0 == strcmp(key, "t")) {
+    switch (lottieKey(key)) {
+    case lottieKey("t"):
         RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
         obj->mGradientType = GetInt();
-    } else if (0 == strcmp(key, "o")) {
+        break;
+    case lottieKey("o"):
         parseProperty(obj->mOpacity);
-    } else if (0 == strcmp(key, "s")) {
+        break;
+    case lottieKey("s"):
         parseProperty(obj->mStartPoint);
-    } else if (0 == strcmp(key, "e")) {
+        break;
+    case lottieKey("e"):
         parseProperty(obj->mEndPoint);
-    } else if (0 == strcmp(key, "h")) {
+        break;
+    case lottieKey("h"):
         parseProperty(obj->mHighlightLength);
-    } else if (0 == strcmp(key, "a")) {
+        break;
+    case lottieKey("a"):
         parseProperty(obj->mHighlightAngle);
-    } else if (0 == strcmp(key, "g")) {
+        break;
+    case lottieKey("g"):
         EnterObject();
         while (const char *rkey = NextObjectKey()) {
-            if (0 == strcmp(rkey, "k")) {
+            switch (lottieKey(rkey)) {
+            case lottieKey("k"):
                 parseProperty(obj->mGradient);
-            } else if (0 == strcmp(rkey, "p")) {
+                break;
+            case lottieKey("p"):
                 obj->mColorPoints = GetInt();
-            } else {
+                break;
+            default:
                 Skip(nullptr);
+                break;
             }
         }
-    } else if (0 == strcmp(key, "hd")) {
+        break;
+    case lottieKey("hd"):
         obj->setHidden(GetBool());
-    } else {
+        break;
+    default:
 #ifdef DEBUG_PARSER
         vWarning << "Gradient property skipped = " << key;
 #endif
         Skip(key);
+        break;
     }
     obj->setStatic(
         obj->mOpacity.isStatic() && obj->mStartPoint.isStatic() &&
@@ -4885,12 +5788,16 @@ LOTGFillData* LottieParserImpl::parseGFillObject()
     auto obj = allocator().make<LOTGFillData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "r")) {
+            break;
+        case lottieKey("r"):
             obj->mFillRule = getFillRule();
-        } else {
+            break;
+        default:
             parseGradientProperty(obj, key);
+            break;
         }
     }
     return obj;
@@ -4904,11 +5811,14 @@ void LottieParserImpl::parseDashProperty(LOTDashProperty &dash)
         RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
         EnterObject();
         while (const char *key = NextObjectKey()) {
-            if (0 == strcmp(key, "v")) {
+            switch (lottieKey(key)) {
+            case lottieKey("v"):
                 dash.mData.emplace_back();
                 parseProperty(dash.mData.back());
-            } else {
+                break;
+            default:
                 Skip(key);
+                break;
             }
         }
     }
@@ -4922,21 +5832,29 @@ LOTGStrokeData* LottieParserImpl::parseGStrokeObject()
     auto obj = allocator().make<LOTGStrokeData>();
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "nm")) {
+        switch (lottieKey(key)) {
+        case lottieKey("nm"):
             obj->setName(GetString());
-        } else if (0 == strcmp(key, "w")) {
+            break;
+        case lottieKey("w"):
             parseProperty(obj->mWidth);
-        } else if (0 == strcmp(key, "lc")) {
+            break;
+        case lottieKey("lc"):
             obj->mCapStyle = getLineCap();
-        } else if (0 == strcmp(key, "lj")) {
+            break;
+        case lottieKey("lj"):
             obj->mJoinStyle = getLineJoin();
-        } else if (0 == strcmp(key, "ml")) {
+            break;
+        case lottieKey("ml"):
             RAPIDJSON_ASSERT(PeekType() == rapidjson::kNumberType);
             obj->mMiterLimit = (float)GetDouble();
-        } else if (0 == strcmp(key, "d")) {
+            break;
+        case lottieKey("d"):
             parseDashProperty(obj->mDash);
-        } else {
+            break;
+        default:
             parseGradientProperty(obj, key);
+            break;
         }
     }
 
@@ -5049,17 +5967,23 @@ void LottieParserImpl::getValue(LottieShapeData &obj)
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "i")) {
+        switch (lottieKey(key)) {
+        case lottieKey("i"):
             getValue(mInPoint);
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             getValue(mOutPoint);
-        } else if (0 == strcmp(key, "v")) {
+            break;
+        case lottieKey("v"):
             getValue(mVertices);
-        } else if (0 == strcmp(key, "c")) {
+            break;
+        case lottieKey("c"):
             closed = GetBool();
-        } else {
+            break;
+        default:
             RAPIDJSON_ASSERT(0);
             Skip(nullptr);
+            break;
         }
     }
     // exit properly from the array
@@ -5108,11 +6032,15 @@ VPointF LottieParserImpl::parseInperpolatorPoint()
     RAPIDJSON_ASSERT(PeekType() == rapidjson::kObjectType);
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "x")) {
+        switch (lottieKey(key)) {
+        case lottieKey("x"):
             getValue(cp.rx());
+            break;
         }
-        if (0 == strcmp(key, "y")) {
+        switch (lottieKey(key)) {
+        case lottieKey("y"):
             getValue(cp.ry());
+            break;
         }
     }
     return cp;
@@ -5128,26 +6056,35 @@ template <>
 bool LottieParserImpl::parseKeyFrameValue(const char *               key,
                                           LOTKeyFrameValue<VPointF> &value)
 {
-    if (0 == strcmp(key, "ti")) {
+    switch (lottieKey(key)) {
+    case lottieKey("ti"):
         value.mPathKeyFrame = true;
         getValue(value.mInTangent);
-    } else if (0 == strcmp(key, "to")) {
+        break;
+    case lottieKey("to"):
         value.mPathKeyFrame = true;
         getValue(value.mOutTangent);
-    } else {
+        break;
+    default:
         return false;
     }
     return true;
 }
 
-VInterpolator* LottieParserImpl::interpolator(VPointF inTangent, VPointF outTangent, const char* key)
+static std::atomic<float> easingTableMaxError{0.0f};
+
+void LottieLoader::configureEasingTable(float maxError)
+{
+    easingTableMaxError = maxError;
+}
+
+VInterpolator* LottieParserImpl::interpolator(VPointF inTangent, VPointF outTangent)
 {
-    if (strlen(key) == 0) {
-        std::vector<char> temp(20);
-        snprintf(temp.data(), temp.size(), "%.2f_%.2f_%.2f_%.2f", inTangent.x(),
-                 inTangent.y(), outTangent.x(), outTangent.y());
-        key = temp.data();
-    }
+    // keyed by exact tangents rather than "n" names, keyframes without name
+    // were all cached as "unk" and got curve of the first one
+    const float tangents[4] = {inTangent.x(), inTangent.y(), outTangent.x(),
+                               outTangent.y()};
+    const std::string key(reinterpret_cast<const char *>(tangents), sizeof(tangents));
 
     auto search = mInterpolatorCache.find(key);
 
@@ -5156,6 +6093,7 @@ VInterpolator* LottieParserImpl::interpolator(VPointF inTangent, VPointF outTang
     }
 
     auto obj = allocator().make<VInterpolator>(outTangent, inTangent);
+    obj->buildTable(easingTableMaxError);
     mInterpolatorCache[key] = obj;
     return obj;
 }
@@ -5167,7 +6105,6 @@ template <typename T>
 void LottieParserImpl::parseKeyFrame(LOTAnimInfo<T> &obj)
 {
     struct ParsedField {
-        std::string interpolatorKey;
         bool        interpolator{false};
         bool        value{false};
         bool        hold{false};
@@ -5181,48 +6118,36 @@ void LottieParserImpl::parseKeyFrame(LOTAnimInfo<T> &obj)
     VPointF        outTangent;
 
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "i")) {
+        switch (lottieKey(key)) {
+        case lottieKey("i"):
             parsed.interpolator = true;
             inTangent = parseInperpolatorPoint();
-        } else if (0 == strcmp(key, "o")) {
+            break;
+        case lottieKey("o"):
             outTangent = parseInperpolatorPoint();
-        } else if (0 == strcmp(key, "t")) {
+            break;
+        case lottieKey("t"):
             keyframe.mStartFrame = (float)GetDouble();
-        } else if (0 == strcmp(key, "s")) {
+            break;
+        case lottieKey("s"):
             parsed.value = true;
             getValue(keyframe.mValue.mStartValue);
-            continue;
-        } else if (0 == strcmp(key, "e")) {
+            break;
+        case lottieKey("e"):
             parsed.noEndValue = false;
             getValue(keyframe.mValue.mEndValue);
-            continue;
-        } else if (0 == strcmp(key, "n")) {
-            if (PeekType() == rapidjson::kStringType) {
-                parsed.interpolatorKey = GetString();
-            } else {
-                RAPIDJSON_ASSERT(PeekType() == rapidjson::kArrayType);
-                EnterArray();
-                while (NextArrayValue()) {
-                    RAPIDJSON_ASSERT(PeekType() == rapidjson::kStringType);
-                    if (parsed.interpolatorKey.empty()) {
-                        parsed.interpolatorKey = GetString();
-                    } else {
-                        // skip rest of the string
-                        GetString();
-                    }
-                }
-            }
-            continue;
-        } else if (parseKeyFrameValue(key, keyframe.mValue)) {
-            continue;
-        } else if (0 == strcmp(key, "h")) {
+            break;
+        case lottieKey("h"):
             parsed.hold = GetInt();
-            continue;
-        } else {
+            break;
+        default:
+            if (parseKeyFrameValue(key, keyframe.mValue))
+                break;
 #ifdef DEBUG_PARSER
             vDebug << "key frame property skipped = " << key;
 #endif
             Skip(key);
+            break;
         }
     }
 
@@ -5240,7 +6165,7 @@ void LottieParserImpl::parseKeyFrame(LOTAnimInfo<T> &obj)
         keyframe.mEndFrame = keyframe.mStartFrame;
         obj.mKeyFrames.push_back(std::move(keyframe));
     } else if (parsed.interpolator) {
-        keyframe.mInterpolator = interpolator(inTangent, outTangent, parsed.interpolatorKey.size() > 0 ? parsed.interpolatorKey.c_str() : "unk");
+        keyframe.mInterpolator = interpolator(inTangent, outTangent);
         obj.mKeyFrames.push_back(std::move(keyframe));
     } else {
         // its the last frame discard.
@@ -5258,7 +6183,8 @@ void LottieParserImpl::parseShapeProperty(LOTAnimatable<LottieShapeData> &obj)
 {
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "k")) {
+        switch (lottieKey(key)) {
+        case lottieKey("k"):
             if (PeekType() == rapidjson::kArrayType) {
                 EnterArray();
                 while (NextArrayValue()) {
@@ -5273,11 +6199,13 @@ void LottieParserImpl::parseShapeProperty(LOTAnimatable<LottieShapeData> &obj)
                 }
                 getValue(obj.value());
             }
-        } else {
+            break;
+        default:
 #ifdef DEBUG_PARSER
             vDebug << "shape property ignored = " << key;
 #endif
             Skip(nullptr);
+            break;
         }
     }
 }
@@ -5330,10 +6258,13 @@ void LottieParserImpl::parseProperty(LOTAnimatable<T> &obj)
 {
     EnterObject();
     while (const char *key = NextObjectKey()) {
-        if (0 == strcmp(key, "k")) {
+        switch (lottieKey(key)) {
+        case lottieKey("k"):
             parsePropertyHelper(obj);
-        } else {
+            break;
+        default:
             Skip(key);
+            break;
         }
     }
 }
@@ -5521,14 +6452,203 @@ public:
 
 #endif
 
+static std::atomic<size_t>   parallelParseMinBytes{64 * 1024};
+static std::atomic<unsigned> parallelParseMaxThreads{1};
+// parsers running now, on load pool several files are parsed at once and
+// share cores between their part threads
+static std::atomic<unsigned> activeParsers{0};
+
+void LottieLoader::configureParallelParse(size_t minBytes, unsigned maxThreads)
+{
+    parallelParseMinBytes = minBytes;
+    parallelParseMaxThreads = maxThreads;
+}
+
+static size_t skipSpace(const char *str, size_t i)
+{
+    while (str[i] == ' ' || str[i] == '\n' || str[i] == '\r' || str[i] == '\t') i++;
+    return i;
+}
+
+// i is at opening quote, returns position past closing one or 0 on end
+static size_t skipString(const char *str, size_t i)
+{
+    for (i++; str[i]; i++) {
+        if (str[i] == '\\') {
+            if (!str[++i]) return 0;
+        } else if (str[i] == '"') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// returns position past json value at i or 0 when json is broken, nested
+// values are only matched by brackets, real parse reports errors in them
+static size_t skipJsonValue(const char *str, size_t i)
+{
+    if (str[i] == '"') return skipString(str, i);
+    if (str[i] != '{' && str[i] != '[') {
+        while (str[i] && !strchr(",]} \n\r\t", str[i])) i++;
+        return str[i] ? i : 0;
+    }
+    int depth = 0;
+    while (str[i]) {
+        switch (str[i]) {
+        case '"':
+            i = skipString(str, i);
+            if (!i) return 0;
+            continue;
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0) return i + 1;
+            break;
+        default:
+            break;
+        }
+        i++;
+    }
+    return 0;
+}
+
+// finds elements of top level assets and layers arrays without parsing them
+static bool scanParts(const char *str, LottieParts &parts)
+{
+    size_t i = skipSpace(str, 0);
+    if (str[i] != '{') return false;
+    i = skipSpace(str, i + 1);
+    while (str[i] == '"') {
+        const size_t keyBegin = i + 1;
+        i = skipString(str, i);
+        if (!i) return false;
+        const std::string key(str + keyBegin, i - 1 - keyBegin);
+        i = skipSpace(str, i);
+        if (str[i] != ':') return false;
+        i = skipSpace(str, i + 1);
+
+        LottieParts::Range *array = nullptr;
+        std::vector<LottieParts::Range> *elements = nullptr;
+        if (key == "assets" && str[i] == '[') {
+            array = &parts.assetsArray;
+            elements = &parts.assets;
+        } else if (key == "layers" && str[i] == '[') {
+            array = &parts.layersArray;
+            elements = &parts.layers;
+        }
+        if (array) {
+            // same array twice, last one wins in parser
+            if (array->end) return false;
+            array->begin = i;
+            i = skipSpace(str, i + 1);
+            while (str[i] != ']') {
+                const size_t begin = i;
+                i = skipJsonValue(str, i);
+                if (!i) return false;
+                elements->push_back({begin, i});
+                i = skipSpace(str, i);
+                if (str[i] == ',')
+                    i = skipSpace(str, i + 1);
+                else if (str[i] != ']')
+                    return false;
+            }
+            array->end = ++i;
+        } else {
+            i = skipJsonValue(str, i);
+            if (!i) return false;
+        }
+        i = skipSpace(str, i);
+        if (str[i] == ',') i = skipSpace(str, i + 1);
+    }
+    return str[i] == '}';
+}
+
+// composition json with emptied assets and layers arrays
+static std::string partsHeader(const char *str, size_t length,
+                               const LottieParts &parts)
+{
+    LottieParts::Range first = parts.assetsArray, second = parts.layersArray;
+    if (!first.end || (second.end && second.begin < first.begin))
+        std::swap(first, second);
+
+    std::string header;
+    size_t      pos = 0;
+    for (const auto &array : {first, second}) {
+        if (!array.end) continue;
+        header.append(str + pos, array.begin - pos);
+        header.append("[]");
+        pos = array.end;
+    }
+    header.append(str + pos, length - pos);
+    return header;
+}
+
+// parses assets and layers of composition on worker threads, each has its
+// own arena and interpolator cache
+static void parseParts(char *str, const char *dir_path, LottieParts &parts,
+                       unsigned threads)
+{
+    // bytes following elements become string ends, so each element is parsed
+    // in place as separate json. Ranges don't overlap and rapidjson writes
+    // decoded strings only inside them
+    for (const auto &range : parts.assets) str[range.end] = '\0';
+    for (const auto &range : parts.layers) str[range.end] = '\0';
+
+    parts.composition = std::make_shared<LOTCompositionData>();
+    parts.assetData.resize(parts.assets.size(), nullptr);
+    parts.layerData.resize(parts.layers.size(), nullptr);
+
+    std::vector<std::unique_ptr<LottieParserImpl>> parsers;
+    for (unsigned i = 0; i < threads; i++) {
+        parts.composition->mPartArenas.push_back(std::make_unique<VArenaAlloc>(2048));
+        parsers.push_back(std::make_unique<LottieParserImpl>(
+            dir_path, parts.composition.get(),
+            parts.composition->mPartArenas.back().get()));
+    }
+
+    std::atomic<size_t>      next{0};
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back([&, i]() { parsers[i]->parseParts(str, parts, next); });
+    parsers[0]->parseParts(str, parts, next);
+    for (auto &worker : workers) worker.join();
+
+    for (auto &parser : parsers)
+        parser->takeLayersToUpdate(parts.layersToUpdate);
+}
+
 LottieParser::~LottieParser() = default;
 LottieParser::LottieParser(char *str, const char *dir_path)
-    : d(std::make_unique<LottieParserImpl>(str, dir_path))
 {
+    LottieParts parts;
+    std::string header;
+    const size_t length = strlen(str);
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned active = ++activeParsers;
+    unsigned threads = parallelParseMaxThreads;
+    if (!threads) threads = cores;
+    threads = std::min(threads, std::max(1u, cores / active));
+
+    if (threads > 1 && length >= parallelParseMinBytes && scanParts(str, parts) &&
+        parts.count() > 1 && parts.bytes() >= length / 2) {
+        header = partsHeader(str, length, parts);
+        parseParts(str, dir_path, parts,
+                   unsigned(std::min<size_t>(threads, parts.count())));
+        d = std::make_unique<LottieParserImpl>(&header[0], dir_path);
+        d->setParts(&parts);
+    } else {
+        d = std::make_unique<LottieParserImpl>(str, dir_path);
+    }
+
     if (d->VerifyType())
         d->parseComposition();
     else
         vWarning << "Input data is not Lottie format!";
+    --activeParsers;
+    d->setParts(nullptr);
 }
 
 std::shared_ptr<LOTModel> LottieParser::model()
@@ -5665,6 +6785,8 @@ void LOTCompositionData::updateStats()
 {
     LottieUpdateStatVisitor visitor(&mStats);
     visitor.visit(mRootLayer);
+
+    for (const auto &asset : mAssets) mStats.imageBytes += asset.second->imageBytes();
 }
 
 VMatrix LOTRepeaterTransform::matrix(int frameNo, float multiplier) const
@@ -5716,249 +6838,1805 @@ void LOTDashProperty::getDashInfo(int frameNo, std::vector<float>& result) const
 
     if (mData.empty()) return;
 
-    if (result.capacity() < mData.size()) result.reserve(mData.size() + 1);
+    if (result.capacity() < mData.size()) result.reserve(mData.size() + 1);
+
+    for (const auto &elm : mData)
+        result.push_back(elm.value(frameNo));
+
+    // if the size is even then we are missing last
+    // gap information which is same as the last dash value
+    // copy it from the last dash value.
+    // NOTE: last value is the offset and last-1 is the last dash value.
+    auto size = result.size();
+    if ((size % 2) == 0) {
+        //copy offset value to end.
+        result.push_back(result.back());
+        // copy dash value to gap.
+        result[size-1] = result[size-2];
+    }
+}
+
+/**
+* Both the color stops and opacity stops are in the same array.
+* There are {@link #colorPoints} colors sequentially as:
+* [
+*     ...,
+*     position,
+*     red,
+*     green,
+*     blue,
+*     ...
+* ]
+*
+* The remainder of the array is the opacity stops sequentially as:
+* [
+*     ...,
+*     position,
+*     opacity,
+*     ...
+* ]
+*/
+void LOTGradient::populate(VGradientStops &stops, int frameNo)
+{
+    LottieGradient gradData = mGradient.value(frameNo);
+    auto            size = gradData.mGradient.size();
+    float *        ptr = gradData.mGradient.data();
+    int            colorPoints = mColorPoints;
+    if (colorPoints == -1) {  // for legacy bodymovin (ref: lottie-android)
+        colorPoints = int(size / 4);
+    }
+    auto    opacityArraySize = size - colorPoints * 4;
+    float *opacityPtr = ptr + (colorPoints * 4);
+    stops.clear();
+    size_t j = 0;
+    for (int i = 0; i < colorPoints; i++) {
+        float       colorStop = ptr[0];
+        LottieColor color = LottieColor(ptr[1], ptr[2], ptr[3]);
+        if (opacityArraySize) {
+            if (j == opacityArraySize) {
+                // already reached the end
+                float stop1 = opacityPtr[j - 4];
+                float op1 = opacityPtr[j - 3];
+                float stop2 = opacityPtr[j - 2];
+                float op2 = opacityPtr[j - 1];
+                if (colorStop > stop2) {
+                    stops.push_back(
+                        std::make_pair(colorStop, color.toColor(op2)));
+                } else {
+                    float progress = (colorStop - stop1) / (stop2 - stop1);
+                    float opacity = op1 + progress * (op2 - op1);
+                    stops.push_back(
+                        std::make_pair(colorStop, color.toColor(opacity)));
+                }
+                continue;
+            }
+            for (; j < opacityArraySize; j += 2) {
+                float opacityStop = opacityPtr[j];
+                if (opacityStop < colorStop) {
+                    // add a color using opacity stop
+                    stops.push_back(std::make_pair(
+                        opacityStop, color.toColor(opacityPtr[j + 1])));
+                    continue;
+                }
+                // add a color using color stop
+                if (j == 0) {
+                    stops.push_back(std::make_pair(
+                        colorStop, color.toColor(opacityPtr[j + 1])));
+                } else {
+                    float progress = (colorStop - opacityPtr[j - 2]) /
+                        (opacityPtr[j] - opacityPtr[j - 2]);
+                    float opacity =
+                        opacityPtr[j - 1] +
+                        progress * (opacityPtr[j + 1] - opacityPtr[j - 1]);
+                    stops.push_back(
+                        std::make_pair(colorStop, color.toColor(opacity)));
+                }
+                j += 2;
+                break;
+            }
+        } else {
+            stops.push_back(std::make_pair(colorStop, color.toColor()));
+        }
+        ptr += 4;
+    }
+}
+
+void LOTGradient::update(std::unique_ptr<VGradient> &grad, int frameNo)
+{
+    bool init = false;
+    if (!grad) {
+        if (mGradientType == 1)
+            grad = std::make_unique<VGradient>(VGradient::Type::Linear);
+        else
+            grad = std::make_unique<VGradient>(VGradient::Type::Radial);
+        grad->mSpread = VGradient::Spread::Pad;
+        init = true;
+    }
+
+    if (!mGradient.isStatic() || init) {
+        populate(grad->mStops, frameNo);
+    }
+
+    if (mGradientType == 1) {  // linear gradient
+        VPointF start = mStartPoint.value(frameNo);
+        VPointF end = mEndPoint.value(frameNo);
+        grad->linear.x1 = start.x();
+        grad->linear.y1 = start.y();
+        grad->linear.x2 = end.x();
+        grad->linear.y2 = end.y();
+    } else {  // radial gradient
+        VPointF start = mStartPoint.value(frameNo);
+        VPointF end = mEndPoint.value(frameNo);
+        grad->radial.cx = start.x();
+        grad->radial.cy = start.y();
+        grad->radial.cradius =
+            VLine::length(start.x(), start.y(), end.x(), end.y());
+        /*
+        * Focal point is the point lives in highlight length distance from
+        * center along the line (start, end)  and rotated by highlight angle.
+        * below calculation first finds the quadrant(angle) on which the point
+        * lives by applying inverse slope formula then adds the rotation angle
+        * to find the final angle. then point is retrived using circle equation
+        * of center, angle and distance.
+        */
+        float progress = mHighlightLength.value(frameNo) / 100.0f;
+        if (vCompare(progress, 1.0f)) progress = 0.99f;
+        float startAngle = VLine(start, end).angle();
+        float highlightAngle = mHighlightAngle.value(frameNo);
+        static constexpr float K_PI = 3.1415926f;
+        float angle = (startAngle + highlightAngle) * (K_PI / 180.0f);
+        grad->radial.fx =
+            grad->radial.cx + std::cos(angle) * progress * grad->radial.cradius;
+        grad->radial.fy =
+            grad->radial.cy + std::sin(angle) * progress * grad->radial.cradius;
+        // Lottie dosen't have any focal radius concept.
+        grad->radial.fradius = 0;
+    }
+}
+
+std::vector<LayerInfo> LOTCompositionData::layerInfoList() const
+{
+    if (!mRootLayer || mRootLayer->mChildren.empty()) return {};
+
+    std::vector<LayerInfo> result;
+
+    result.reserve(mRootLayer->mChildren.size());
+
+    for (auto it : mRootLayer->mChildren) {
+        auto layer = static_cast<LOTLayerData *>(it);
+        result.emplace_back(layer->name(), layer->mInFrame, layer->mOutFrame);
+    }
+
+    return result;
+}
+
+// Parsed models are immutable, so animations loaded from same file share one model.
+// Recently used models are kept in LRU list until their summary memoryUsage() fit
+// in budget, so reopened animation is not parsed again. Evicted models still shared
+// while any animation use them
+class LottieModelCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 32 * 1024 * 1024;
+
+    static LottieModelCache &instance()
+    {
+        static LottieModelCache CACHE;
+        return CACHE;
+    }
+    std::shared_ptr<LOTModel> find(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mModels.find(key);
+        if (it == mModels.end()) return nullptr;
+
+        auto model = it->second.model.lock();
+        if (!model) {
+            mModels.erase(it);
+            return nullptr;
+        }
+
+        if (it->second.cached) {
+            mLru.splice(mLru.begin(), mLru, it->second.lru);
+        } else {
+            pushFront(it, model);
+            evict();
+        }
+        return model;
+    }
+    void add(const std::string &key, std::shared_ptr<LOTModel> value)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // forget models which were freed with their animations
+        for (auto it = mModels.begin(); it != mModels.end();) {
+            it = (!it->second.cached && it->second.model.expired()) ? mModels.erase(it) : std::next(it);
+        }
+
+        auto it = mModels.find(key);
+        if (it != mModels.end() && it->second.cached) {
+            mBytes -= it->second.lru->bytes;
+            mLru.erase(it->second.lru);
+        }
+        it = mModels.insert_or_assign(key, Entry{value, {}, false}).first;
+        pushFront(it, value);
+        evict();
+    }
+    // budget in bytes, 0 disables caching of unused models
+    void configureCacheSize(size_t cacheSize)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBudget = cacheSize;
+        evict();
+    }
+
+private:
+    struct Cached {
+        std::shared_ptr<LOTModel> model;
+        size_t                    bytes;
+        const std::string        *key;
+    };
+    struct Entry {
+        std::weak_ptr<LOTModel>   model;
+        std::list<Cached>::iterator lru;
+        bool                      cached;
+    };
+
+    void pushFront(std::unordered_map<std::string, Entry>::iterator it, const std::shared_ptr<LOTModel> &model)
+    {
+        const size_t bytes = model->memoryUsage();
+        mLru.push_front({model, bytes, &it->first});
+        mBytes += bytes;
+        it->second.lru = mLru.begin();
+        it->second.cached = true;
+    }
+    void evict()
+    {
+        while (!mLru.empty() && mBytes > mBudget) {
+            auto &last = mLru.back();
+            auto it = mModels.find(*last.key);
+            it->second.cached = false;
+            mBytes -= last.bytes;
+            mLru.pop_back();
+        }
+    }
+
+    std::mutex                              mMutex;
+    std::unordered_map<std::string, Entry>  mModels;
+    std::list<Cached>                       mLru;
+    size_t                                  mBytes{0};
+    size_t                                  mBudget{DEFAULT_BUDGET};
+};
+
+void LottieLoader::configureModelCacheSize(size_t cacheSize)
+{
+    LottieModelCache::instance().configureCacheSize(cacheSize);
+}
+
+// key of file in model and image caches, same file reached by another path
+// has same key, and file changed on disk has new key
+static std::string fileCacheKey(const std::string &path)
+{
+    std::error_code ec;
+    auto canonical = std::filesystem::canonical(path, ec);
+    if (ec) return path;
+
+    auto mtime = std::filesystem::last_write_time(canonical, ec);
+    std::string key = canonical.string();
+    if (!ec) key += "|" + std::to_string(mtime.time_since_epoch().count());
+    return key;
+}
+
+static std::string dirname(const std::string &path)
+{
+    const char *ptr = strrchr(path.c_str(), '/');
+#ifdef _WIN32
+    if (ptr) ptr = strrchr(ptr + 1, '\\');
+#endif
+    if (!ptr) return std::string();
+    int         len = int(ptr + 1 - path.c_str());  // +1 to include '/'
+    return std::string(path, 0, len);
+}
+
+// decoded images shared by assets of all animations. Entries only point to
+// bitmaps while some asset holds them, unused ones are kept by lru while they
+// fit in budget
+class VImageCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 16 * 1024 * 1024;
+
+    static VImageCache &instance()
+    {
+        static VImageCache CACHE;
+        return CACHE;
+    }
+    VBitmap find(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        VBitmap result;
+        auto it = mImages.find(key);
+        if (it == mImages.end()) return result;
+
+        result.mImpl = it->second.image.lock();
+        if (!result.mImpl) {
+            mImages.erase(it);
+            return result;
+        }
+
+        if (it->second.cached) {
+            mLru.splice(mLru.begin(), mLru, it->second.lru);
+        } else {
+            pushFront(it, result.mImpl);
+            evict();
+        }
+        return result;
+    }
+    void add(const std::string &key, const VBitmap &bitmap)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // forget images which were freed with their models
+        for (auto it = mImages.begin(); it != mImages.end();) {
+            it = (!it->second.cached && it->second.image.expired()) ? mImages.erase(it) : std::next(it);
+        }
+
+        auto it = mImages.find(key);
+        if (it != mImages.end() && it->second.cached) {
+            mBytes -= it->second.lru->bytes;
+            mLru.erase(it->second.lru);
+        }
+        it = mImages.insert_or_assign(key, Entry{bitmap.mImpl, {}, false}).first;
+        pushFront(it, bitmap.mImpl);
+        evict();
+    }
+    // budget in bytes, 0 keeps only images in use
+    void configureCacheSize(size_t cacheSize)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBudget = cacheSize;
+        evict();
+    }
+
+private:
+    using Image = std::shared_ptr<VBitmap::Impl>;
+    struct Cached {
+        Image              image;
+        size_t             bytes;
+        const std::string *key;
+    };
+    struct Entry {
+        std::weak_ptr<VBitmap::Impl> image;
+        std::list<Cached>::iterator  lru;
+        bool                         cached;
+    };
+
+    void pushFront(std::unordered_map<std::string, Entry>::iterator it, const Image &image)
+    {
+        const size_t bytes = image->stride() * image->height();
+        mLru.push_front({image, bytes, &it->first});
+        mBytes += bytes;
+        it->second.lru = mLru.begin();
+        it->second.cached = true;
+    }
+    void evict()
+    {
+        while (!mLru.empty() && mBytes > mBudget) {
+            auto &last = mLru.back();
+            auto it = mImages.find(*last.key);
+            it->second.cached = false;
+            mBytes -= last.bytes;
+            mLru.pop_back();
+        }
+    }
+
+    std::mutex                              mMutex;
+    std::unordered_map<std::string, Entry>  mImages;
+    std::list<Cached>                       mLru;
+    size_t                                  mBytes{0};
+    size_t                                  mBudget{DEFAULT_BUDGET};
+};
+
+void LottieLoader::configureImageCacheSize(size_t cacheSize)
+{
+    VImageCache::instance().configureCacheSize(cacheSize);
+}
+
+// SHA-256 of data, json or embedded images of different content must never
+// share cache entry
+static std::array<uint8_t, 32> sha256(const std::string &data)
+{
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+        0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+        0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+        0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+        0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+        0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+        0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+
+    // message is padded with 0x80, zeros and bit length to whole blocks
+    const uint64_t bits = uint64_t(data.size()) * 8;
+    const size_t   blocks = (data.size() + 9 + 63) / 64;
+    for (size_t b = 0; b < blocks; b++) {
+        uint8_t block[64];
+        for (size_t i = 0; i < 64; i++) {
+            const size_t pos = b * 64 + i;
+            if (pos < data.size())
+                block[i] = uint8_t(data[pos]);
+            else if (pos == data.size())
+                block[i] = 0x80;
+            else if (pos >= blocks * 64 - 8)
+                block[i] = uint8_t(bits >> (8 * (blocks * 64 - 1 - pos)));
+            else
+                block[i] = 0;
+        }
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++)
+            w[i] = uint32_t(block[4 * i]) << 24 | uint32_t(block[4 * i + 1]) << 16 |
+                   uint32_t(block[4 * i + 2]) << 8 | uint32_t(block[4 * i + 3]);
+        for (int i = 16; i < 64; i++) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t v[8];
+        memcpy(v, h, sizeof(v));
+        for (int i = 0; i < 64; i++) {
+            const uint32_t s1 = rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25);
+            const uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            const uint32_t t1 = v[7] + s1 + ch + K[i] + w[i];
+            const uint32_t s0 = rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22);
+            const uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            const uint32_t t2 = s0 + maj;
+            memmove(v + 1, v, 7 * sizeof(uint32_t));
+            v[4] += t1;
+            v[0] = t1 + t2;
+        }
+        for (int i = 0; i < 8; i++) h[i] += v[i];
+    }
+
+    std::array<uint8_t, 32> digest;
+    for (int i = 0; i < 32; i++) digest[i] = uint8_t(h[i / 4] >> (24 - 8 * (i % 4)));
+    return digest;
+}
+
+// cache key of data given without path is prefix and hex digest of content
+static std::string dataKey(const char *prefix, const std::string &data)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string key = prefix;
+    for (uint8_t byte : sha256(data)) {
+        key += hex[byte >> 4];
+        key += hex[byte & 15];
+    }
+    return key;
+}
+
+void LOTAsset::setImageData(std::string data)
+{
+    mImageSource = std::move(data);
+    mImageFile = false;
+}
+
+void LOTAsset::setImagePath(std::string path)
+{
+    mImageSource = std::move(path);
+    mImageFile = true;
+}
+
+VBitmap LOTAsset::bitmap() const
+{
+    // model may be shared by animations rendering on several threads
+    std::call_once(mImageOnce, [this]() {
+        if (mImageSource.empty()) return;
+        const std::string key = mImageFile ? fileCacheKey(mImageSource)
+                                           : dataKey("data|", mImageSource);
+        mBitmap = VImageCache::instance().find(key);
+        if (!mBitmap.valid()) {
+            if (mImageFile)
+                mBitmap = VImageLoader::instance().load(mImageSource.c_str());
+            else
+                mBitmap = VImageLoader::instance().load(mImageSource.data(),
+                                                        mImageSource.size());
+            if (mBitmap.valid()) VImageCache::instance().add(key, mBitmap);
+        }
+        std::string().swap(mImageSource);
+    });
+    return mBitmap;
+}
+
+size_t LOTAsset::imageBytes() const
+{
+    if (mBitmap.valid()) return mBitmap.stride() * mBitmap.height();
+    // not decoded yet, expect size from asset
+    if (!mImageSource.empty()) return size_t(mWidth) * size_t(mHeight) * 4;
+    return 0;
+}
+
+
+/*
+ * Precompiled model (.lotb). Parsed composition tree is written as stream of
+ * plain values, pointers between nodes replaced by indices, so file can be used
+ * from any address. Header keep format version and hash of json source, blob
+ * which not match json is stale and json is parsed instead.
+ *
+ * Node is written fully when it meet first time, later only its index. Loader
+ * read stream from mapped file and create nodes in composition arena.
+ *
+ * Images are kept as json has them, embedded compressed data or file path.
+ * Path is stored relative to json directory and loaded relative to .lotb file.
+ */
+namespace {
+
+constexpr char     LOTB_MAGIC[4] = {'L', 'O', 'T', 'B'};
+constexpr uint32_t LOTB_VERSION = 5;
+constexpr uint32_t LOTB_BYTE_ORDER = 0x01020304;
+// nesting of groups and layers, deeper file is treated as broken
+constexpr int      LOTB_MAX_DEPTH = 256;
+
+struct LotbHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t sourceHash;
+    uint64_t payloadSize;
+};
+
+enum LotbTag : uint8_t { LOTB_NULL = 0, LOTB_REF, LOTB_NEW };
+
+// FNV-1a, must be same on every platform because stored in file
+uint64_t lotbSourceHash(const char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= uint8_t(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class LotbWriter {
+public:
+    // dirPath is directory of json, image paths are stored relative to it
+    explicit LotbWriter(std::string dirPath) : mDirPath(std::move(dirPath)) {}
+
+    std::vector<uint8_t> mData;
+
+    template <typename T>
+    void pod(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "pod value expected");
+        auto p = reinterpret_cast<const uint8_t *>(&value);
+        mData.insert(mData.end(), p, p + sizeof(T));
+    }
+    void str(const char *s)
+    {
+        const uint32_t len = s ? uint32_t(strlen(s)) : 0;
+        pod(len);
+        mData.insert(mData.end(), s, s + len);
+    }
+    void str(const std::string &s)
+    {
+        pod(uint32_t(s.size()));
+        mData.insert(mData.end(), s.begin(), s.end());
+    }
+    void value(float v) { pod(v); }
+    void value(const VPointF &v) { pod(v.x()); pod(v.y()); }
+    void value(const LottieColor &v) { pod(v.r); pod(v.g); pod(v.b); }
+    void value(const LottieGradient &v)
+    {
+        pod(uint32_t(v.mGradient.size()));
+        for (float f : v.mGradient) pod(f);
+    }
+    void value(const LottieShapeData &v)
+    {
+        pod(uint32_t(v.mPoints.size()));
+        for (const auto &pt : v.mPoints) value(pt);
+        pod(v.mClosed);
+    }
+
+    template <typename T>
+    void keyValue(const LOTKeyFrameValue<T> &v)
+    {
+        value(v.mStartValue);
+        value(v.mEndValue);
+    }
+    void keyValue(const LOTKeyFrameValue<VPointF> &v)
+    {
+        value(v.mStartValue);
+        value(v.mEndValue);
+        value(v.mInTangent);
+        value(v.mOutTangent);
+        pod(v.mPathKeyFrame);
+    }
+
+    void interpolator(const VInterpolator *obj)
+    {
+        if (!obj) return pod(LOTB_NULL);
+        // equal curves are written once, parallel parse may leave copies
+        const std::array<float, 4> curve{obj->p1().x(), obj->p1().y(),
+                                         obj->p2().x(), obj->p2().y()};
+        obj = mCurves.emplace(curve, obj).first->second;
+        if (ref(obj)) return;
+        value(obj->p1());
+        value(obj->p2());
+    }
+
+    template <typename T>
+    void property(const LOTAnimatable<T> &obj)
+    {
+        pod(obj.isStatic());
+        if (obj.isStatic()) return value(obj.value());
+
+        const auto &keyFrames = obj.animation().mKeyFrames;
+        pod(uint32_t(keyFrames.size()));
+        for (const auto &keyFrame : keyFrames) {
+            pod(keyFrame.mStartFrame);
+            pod(keyFrame.mEndFrame);
+            interpolator(keyFrame.mInterpolator);
+            keyValue(keyFrame.mValue);
+        }
+    }
+
+    void dash(const LOTDashProperty &obj)
+    {
+        pod(uint32_t(obj.mData.size()));
+        for (const auto &elm : obj.mData) property(elm);
+    }
+
+    void transform(const LOTTransformData *obj)
+    {
+        if (obj->isStatic()) {
+            // by fields, raw VMatrix has uninitialized padding
+            const VMatrix m = obj->matrix(0);
+            for (float v : {m.m_11(), m.m_12(), m.m_13(), m.m_21(), m.m_22(),
+                            m.m_23(), m.m_tx(), m.m_ty(), m.m_33()})
+                pod(v);
+            pod(obj->opacity(0));
+            return;
+        }
+        const TransformData *d = obj->data();
+        property(d->mRotation);
+        property(d->mScale);
+        property(d->mPosition);
+        property(d->mAnchor);
+        property(d->mOpacity);
+        pod(bool(d->mExtra));
+        if (d->mExtra) {
+            property(d->mExtra->m3DRx);
+            property(d->mExtra->m3DRy);
+            property(d->mExtra->m3DRz);
+            property(d->mExtra->mSeparateX);
+            property(d->mExtra->mSeparateY);
+            pod(d->mExtra->mSeparate);
+            pod(d->mExtra->m3DData);
+        }
+    }
+
+    void asset(const LOTAsset *obj)
+    {
+        if (!obj) return pod(LOTB_NULL);
+        if (ref(obj)) return;
+        pod(obj->mAssetType);
+        pod(obj->mStatic);
+        str(obj->mRefId.c_str());
+        children(obj->mLayers);
+        pod(obj->mWidth);
+        pod(obj->mHeight);
+
+        // image is kept as in json, compressed data or file path, so loaded
+        // model decodes it lazily through image cache. Model is just parsed,
+        // nothing decoded it yet
+        pod(obj->mImageFile);
+        if (obj->mImageFile &&
+            obj->mImageSource.compare(0, mDirPath.size(), mDirPath) == 0)
+            str(obj->mImageSource.substr(mDirPath.size()));
+        else
+            str(obj->mImageSource);
+    }
+
+    void children(const std::vector<LOTData *> &list)
+    {
+        pod(uint32_t(list.size()));
+        for (const auto child : list) node(child);
+    }
+
+    void group(const LOTGroupData *obj)
+    {
+        children(obj->mChildren);
+        node(obj->mTransform);
+    }
+
+    void gradient(const LOTGradient *obj)
+    {
+        pod(obj->mGradientType);
+        property(obj->mStartPoint);
+        property(obj->mEndPoint);
+        property(obj->mHighlightLength);
+        property(obj->mHighlightAngle);
+        property(obj->mOpacity);
+        property(obj->mGradient);
+        pod(obj->mColorPoints);
+        pod(obj->mEnabled);
+    }
+
+    void layer(const LOTLayerData *obj)
+    {
+        group(obj);
+        pod(obj->mMatteType);
+        pod(obj->mLayerType);
+        pod(obj->mBlendMode);
+        pod(obj->mHasPathOperator);
+        pod(obj->mHasMask);
+        pod(obj->mHasRepeater);
+        pod(obj->mHasGradient);
+        pod(obj->mAutoOrient);
+        pod(obj->mLayerSize.width());
+        pod(obj->mLayerSize.height());
+        pod(obj->mParentId);
+        pod(obj->mId);
+        pod(obj->mTimeStreatch);
+        pod(obj->mInFrame);
+        pod(obj->mOutFrame);
+        pod(obj->mStartFrame);
+
+        const ExtraLayerData *extra = obj->mExtra.get();
+        pod(bool(extra));
+        if (!extra) return;
+        value(extra->mSolidColor);
+        str(extra->mPreCompRefId.c_str());
+        property(extra->mTimeRemap);
+        pod(bool(extra->mCompRef));
+        asset(extra->mAsset);
+        pod(uint32_t(extra->mMasks.size()));
+        for (const auto mask : extra->mMasks) {
+            property(mask->mShape);
+            property(mask->mOpacity);
+            pod(mask->mInv);
+            pod(mask->mIsStatic);
+            pod(mask->mMode);
+        }
+    }
+
+    void node(const LOTData *obj)
+    {
+        if (!obj) return pod(LOTB_NULL);
+        if (ref(obj)) return;
+        pod(obj->type());
+        data(obj);
+
+        switch (obj->type()) {
+        case LOTData::Type::Layer:
+            layer(static_cast<const LOTLayerData *>(obj));
+            break;
+        case LOTData::Type::ShapeGroup:
+            group(static_cast<const LOTShapeGroupData *>(obj));
+            break;
+        case LOTData::Type::Transform:
+            transform(static_cast<const LOTTransformData *>(obj));
+            break;
+        case LOTData::Type::Fill: {
+            auto o = static_cast<const LOTFillData *>(obj);
+            pod(o->mFillRule);
+            pod(o->mEnabled);
+            property(o->mColor);
+            property(o->mOpacity);
+            break;
+        }
+        case LOTData::Type::Stroke: {
+            auto o = static_cast<const LOTStrokeData *>(obj);
+            property(o->mColor);
+            property(o->mOpacity);
+            property(o->mWidth);
+            pod(o->mCapStyle);
+            pod(o->mJoinStyle);
+            pod(o->mMiterLimit);
+            dash(o->mDash);
+            pod(o->mEnabled);
+            break;
+        }
+        case LOTData::Type::GFill: {
+            auto o = static_cast<const LOTGFillData *>(obj);
+            gradient(o);
+            pod(o->mFillRule);
+            break;
+        }
+        case LOTData::Type::GStroke: {
+            auto o = static_cast<const LOTGStrokeData *>(obj);
+            gradient(o);
+            property(o->mWidth);
+            pod(o->mCapStyle);
+            pod(o->mJoinStyle);
+            pod(o->mMiterLimit);
+            dash(o->mDash);
+            break;
+        }
+        case LOTData::Type::Rect: {
+            auto o = static_cast<const LOTRectData *>(obj);
+            pod(o->mDirection);
+            property(o->mPos);
+            property(o->mSize);
+            property(o->mRound);
+            break;
+        }
+        case LOTData::Type::Ellipse: {
+            auto o = static_cast<const LOTEllipseData *>(obj);
+            pod(o->mDirection);
+            property(o->mPos);
+            property(o->mSize);
+            break;
+        }
+        case LOTData::Type::Shape: {
+            auto o = static_cast<const LOTShapeData *>(obj);
+            pod(o->mDirection);
+            property(o->mShape);
+            break;
+        }
+        case LOTData::Type::Polystar: {
+            auto o = static_cast<const LOTPolystarData *>(obj);
+            pod(o->mDirection);
+            pod(o->mPolyType);
+            property(o->mPos);
+            property(o->mPointCount);
+            property(o->mInnerRadius);
+            property(o->mOuterRadius);
+            property(o->mInnerRoundness);
+            property(o->mOuterRoundness);
+            property(o->mRotation);
+            break;
+        }
+        case LOTData::Type::Trim: {
+            auto o = static_cast<const LOTTrimData *>(obj);
+            property(o->mStart);
+            property(o->mEnd);
+            property(o->mOffset);
+            pod(o->mTrimType);
+            break;
+        }
+        case LOTData::Type::Repeater: {
+            auto o = static_cast<const LOTRepeaterData *>(obj);
+            node(o->mContent);
+            property(o->mTransform.mRotation);
+            property(o->mTransform.mScale);
+            property(o->mTransform.mPosition);
+            property(o->mTransform.mAnchor);
+            property(o->mTransform.mStartOpacity);
+            property(o->mTransform.mEndOpacity);
+            property(o->mCopies);
+            property(o->mOffset);
+            pod(o->mMaxCopies);
+            pod(o->mProcessed);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void composition(const LOTCompositionData *obj)
+    {
+        data(obj);
+        str(obj->mVersion.c_str());
+        pod(obj->mSize.width());
+        pod(obj->mSize.height());
+        pod(int64_t(obj->mStartFrame));
+        pod(int64_t(obj->mEndFrame));
+        pod(obj->mFrameRate);
+        pod(obj->mBlendMode);
+        node(obj->mRootLayer);
+
+        pod(uint32_t(obj->mAssets.size()));
+        for (const auto &asset : obj->mAssets) {
+            str(asset.first.c_str());
+            this->asset(asset.second);
+        }
+
+        pod(uint32_t(obj->mMarkers.size()));
+        for (const auto &marker : obj->mMarkers) {
+            str(std::get<0>(marker).c_str());
+            pod(int32_t(std::get<1>(marker)));
+            pod(int32_t(std::get<2>(marker)));
+        }
+    }
+
+private:
+    // common part of every node
+    void data(const LOTData *obj)
+    {
+        str(obj->name());
+        pod(obj->isStatic());
+        pod(obj->hidden());
+    }
+
+    // write index when object already written, otherwise remember it
+    bool ref(const void *obj)
+    {
+        auto it = mIndices.find(obj);
+        if (it != mIndices.end()) {
+            pod(LOTB_REF);
+            pod(it->second);
+            return true;
+        }
+        mIndices.emplace(obj, uint32_t(mIndices.size()));
+        pod(LOTB_NEW);
+        return false;
+    }
+
+    std::unordered_map<const void *, uint32_t> mIndices;
+    std::map<std::array<float, 4>, const VInterpolator *> mCurves;
+    std::string mDirPath;
+};
+
+class LotbReader {
+public:
+    // image paths are relative to dirPath, directory of .lotb file
+    LotbReader(const uint8_t *data, size_t size, LOTCompositionData *comp,
+               std::string dirPath)
+        : mPos(data), mEnd(data + size), mComp(comp), mDirPath(std::move(dirPath)) {}
+
+    bool failed() const { return mFailed; }
+
+    template <typename T>
+    T pod()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "pod value expected");
+        T value{};
+        if (size_t(mEnd - mPos) < sizeof(T)) {
+            mFailed = true;
+            mPos = mEnd;
+            return value;
+        }
+        if constexpr (std::is_same<T, bool>::value) {
+            // any byte is valid value in broken file, but not any bool
+            value = *mPos != 0;
+        } else {
+            memcpy(&value, mPos, sizeof(T));
+        }
+        mPos += sizeof(T);
+        return value;
+    }
+    template <typename T>
+    void pod(T &value) { value = pod<T>(); }
+    // renderer switches on enums and expects only known values, payload is
+    // not covered by source hash, so broken file may hold any of them
+    template <typename T>
+    void pod(T &value, T first, T last)
+    {
+        value = pod<T>();
+        if (value < first || value > last) {
+            mFailed = true;
+            value = first;
+        }
+    }
+
+    // count of elements which every take at least minSize bytes, so broken count
+    // can't make huge allocation
+    uint32_t count(size_t minSize = 1)
+    {
+        const uint32_t n = pod<uint32_t>();
+        if (size_t(mEnd - mPos) / minSize < n) {
+            mFailed = true;
+            mPos = mEnd;
+            return 0;
+        }
+        return n;
+    }
+    std::string str()
+    {
+        const uint32_t len = count();
+        std::string result(reinterpret_cast<const char *>(mPos), len);
+        mPos += len;
+        return result;
+    }
+    void value(float &v) { pod(v); }
+    void value(VPointF &v) { v.setX(pod<float>()); v.setY(pod<float>()); }
+    void value(LottieColor &v) { pod(v.r); pod(v.g); pod(v.b); }
+    void value(LottieGradient &v)
+    {
+        v.mGradient.resize(count(sizeof(float)));
+        for (float &f : v.mGradient) pod(f);
+    }
+    void value(LottieShapeData &v)
+    {
+        v.mPoints.resize(count(2 * sizeof(float)));
+        for (auto &pt : v.mPoints) value(pt);
+        pod(v.mClosed);
+    }
+
+    template <typename T>
+    void keyValue(LOTKeyFrameValue<T> &v)
+    {
+        value(v.mStartValue);
+        value(v.mEndValue);
+    }
+    void keyValue(LOTKeyFrameValue<VPointF> &v)
+    {
+        value(v.mStartValue);
+        value(v.mEndValue);
+        value(v.mInTangent);
+        value(v.mOutTangent);
+        pod(v.mPathKeyFrame);
+    }
+
+    VInterpolator *interpolator()
+    {
+        VInterpolator *obj = nullptr;
+        if (ref(obj, Kind::Interpolator)) return obj;
+        obj = allocator().make<VInterpolator>();
+        add(obj, Kind::Interpolator);
+        VPointF p1, p2;
+        value(p1);
+        value(p2);
+        obj->init(p1.x(), p1.y(), p2.x(), p2.y());
+        obj->buildTable(easingTableMaxError);
+        return obj;
+    }
+
+    template <typename T>
+    void property(LOTAnimatable<T> &obj)
+    {
+        if (pod<bool>()) return value(obj.value());
+
+        auto &keyFrames = obj.animation().mKeyFrames;
+        keyFrames.resize(count(2 * sizeof(float) + 1));
+        for (auto &keyFrame : keyFrames) {
+            pod(keyFrame.mStartFrame);
+            pod(keyFrame.mEndFrame);
+            keyFrame.mInterpolator = interpolator();
+            keyValue(keyFrame.mValue);
+        }
+    }
+
+    void dash(LOTDashProperty &obj)
+    {
+        const uint32_t n = count();
+        obj.mData.reserve(n);
+        for (uint32_t i = 0; i < n; i++) {
+            obj.mData.emplace_back(0.0f);
+            property(obj.mData.back());
+        }
+    }
+
+    void transform(LOTTransformData *obj)
+    {
+        if (obj->isStatic()) {
+            float m[9];
+            for (float &v : m) v = pod<float>();
+            obj->set(VMatrix(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]),
+                     pod<float>());
+            return;
+        }
+
+        auto d = allocator().make<TransformData>();
+        property(d->mRotation);
+        property(d->mScale);
+        property(d->mPosition);
+        property(d->mAnchor);
+        property(d->mOpacity);
+        if (pod<bool>()) {
+            d->createExtraData();
+            property(d->mExtra->m3DRx);
+            property(d->mExtra->m3DRy);
+            property(d->mExtra->m3DRz);
+            property(d->mExtra->mSeparateX);
+            property(d->mExtra->mSeparateY);
+            pod(d->mExtra->mSeparate);
+            pod(d->mExtra->m3DData);
+        }
+        obj->set(d, false);
+    }
+
+    LOTAsset *asset()
+    {
+        LOTAsset *obj = nullptr;
+        if (ref(obj, Kind::Asset)) return obj;
+        obj = allocator().make<LOTAsset>();
+        add(obj, Kind::Asset);
+        pod(obj->mAssetType, LOTAsset::Type::Precomp, LOTAsset::Type::Char);
+        pod(obj->mStatic);
+        obj->mRefId = str();
+        children(obj->mLayers);
+        pod(obj->mWidth);
+        pod(obj->mHeight);
+
+        const bool imageFile = pod<bool>();
+        std::string source = str();
+        if (!source.empty()) {
+            if (imageFile)
+                obj->setImagePath(mDirPath + source);
+            else
+                obj->setImageData(std::move(source));
+        }
+        return obj;
+    }
+
+    void children(std::vector<LOTData *> &list)
+    {
+        list.resize(count());
+        for (auto &child : list) {
+            child = node();
+            if (!child) mFailed = true;
+        }
+    }
+
+    void group(LOTGroupData *obj)
+    {
+        children(obj->mChildren);
+        LOTData *transform = node();
+        if (transform && transform->type() != LOTData::Type::Transform) mFailed = true;
+        obj->mTransform = static_cast<LOTTransformData *>(transform);
+    }
+
+    void gradient(LOTGradient *obj)
+    {
+        pod(obj->mGradientType, 1, 2);
+        property(obj->mStartPoint);
+        property(obj->mEndPoint);
+        property(obj->mHighlightLength);
+        property(obj->mHighlightAngle);
+        property(obj->mOpacity);
+        property(obj->mGradient);
+        pod(obj->mColorPoints);
+        pod(obj->mEnabled);
+    }
+
+    void layer(LOTLayerData *obj)
+    {
+        group(obj);
+        pod(obj->mMatteType, MatteType::None, MatteType::LumaInv);
+        pod(obj->mLayerType, LayerType::Precomp, LayerType::Text);
+        pod(obj->mBlendMode, LottieBlendMode::Normal, LottieBlendMode::OverLay);
+        pod(obj->mHasPathOperator);
+        pod(obj->mHasMask);
+        pod(obj->mHasRepeater);
+        pod(obj->mHasGradient);
+        pod(obj->mAutoOrient);
+        obj->mLayerSize.setWidth(pod<int>());
+        obj->mLayerSize.setHeight(pod<int>());
+        pod(obj->mParentId);
+        pod(obj->mId);
+        pod(obj->mTimeStreatch);
+        pod(obj->mInFrame);
+        pod(obj->mOutFrame);
+        pod(obj->mStartFrame);
+
+        if (!pod<bool>()) return;
+        ExtraLayerData *extra = obj->extra();
+        value(extra->mSolidColor);
+        extra->mPreCompRefId = str();
+        property(extra->mTimeRemap);
+        if (pod<bool>()) extra->mCompRef = mComp;
+        extra->mAsset = asset();
+        const uint32_t n = count();
+        extra->mMasks.reserve(n);
+        for (uint32_t i = 0; i < n && !mFailed; i++) {
+            auto mask = allocator().make<LOTMaskData>();
+            property(mask->mShape);
+            property(mask->mOpacity);
+            pod(mask->mInv);
+            pod(mask->mIsStatic);
+            pod(mask->mMode, LOTMaskData::Mode::None, LOTMaskData::Mode::Difference);
+            extra->mMasks.push_back(mask);
+        }
+    }
+
+    LOTData *node()
+    {
+        LOTData *obj = nullptr;
+        if (ref(obj, Kind::Node)) return obj;
+
+        // children are read recursively, broken nesting must not overflow stack
+        struct Nesting {
+            int &depth;
+            ~Nesting() { depth--; }
+        } nesting{++mDepth};
+        if (mDepth > LOTB_MAX_DEPTH) {
+            mFailed = true;
+            return nullptr;
+        }
+
+        const auto type = pod<LOTData::Type>();
+        switch (type) {
+        case LOTData::Type::Layer: {
+            auto o = make<LOTLayerData>();
+            obj = o;
+            layer(o);
+            break;
+        }
+        case LOTData::Type::ShapeGroup: {
+            auto o = make<LOTShapeGroupData>();
+            obj = o;
+            group(o);
+            break;
+        }
+        case LOTData::Type::Transform: {
+            auto o = make<LOTTransformData>();
+            obj = o;
+            transform(o);
+            break;
+        }
+        case LOTData::Type::Fill: {
+            auto o = make<LOTFillData>();
+            obj = o;
+            pod(o->mFillRule, FillRule::EvenOdd, FillRule::Winding);
+            pod(o->mEnabled);
+            property(o->mColor);
+            property(o->mOpacity);
+            break;
+        }
+        case LOTData::Type::Stroke: {
+            auto o = make<LOTStrokeData>();
+            obj = o;
+            property(o->mColor);
+            property(o->mOpacity);
+            property(o->mWidth);
+            pod(o->mCapStyle, CapStyle::Flat, CapStyle::Round);
+            pod(o->mJoinStyle, JoinStyle::Miter, JoinStyle::Round);
+            pod(o->mMiterLimit);
+            dash(o->mDash);
+            pod(o->mEnabled);
+            break;
+        }
+        case LOTData::Type::GFill: {
+            auto o = make<LOTGFillData>();
+            obj = o;
+            gradient(o);
+            pod(o->mFillRule, FillRule::EvenOdd, FillRule::Winding);
+            break;
+        }
+        case LOTData::Type::GStroke: {
+            auto o = make<LOTGStrokeData>();
+            obj = o;
+            gradient(o);
+            property(o->mWidth);
+            pod(o->mCapStyle, CapStyle::Flat, CapStyle::Round);
+            pod(o->mJoinStyle, JoinStyle::Miter, JoinStyle::Round);
+            pod(o->mMiterLimit);
+            dash(o->mDash);
+            break;
+        }
+        case LOTData::Type::Rect: {
+            auto o = make<LOTRectData>();
+            obj = o;
+            pod(o->mDirection);
+            property(o->mPos);
+            property(o->mSize);
+            property(o->mRound);
+            break;
+        }
+        case LOTData::Type::Ellipse: {
+            auto o = make<LOTEllipseData>();
+            obj = o;
+            pod(o->mDirection);
+            property(o->mPos);
+            property(o->mSize);
+            break;
+        }
+        case LOTData::Type::Shape: {
+            auto o = make<LOTShapeData>();
+            obj = o;
+            pod(o->mDirection);
+            property(o->mShape);
+            break;
+        }
+        case LOTData::Type::Polystar: {
+            auto o = make<LOTPolystarData>();
+            obj = o;
+            pod(o->mDirection);
+            pod(o->mPolyType, LOTPolystarData::PolyType::Star, LOTPolystarData::PolyType::Polygon);
+            property(o->mPos);
+            property(o->mPointCount);
+            property(o->mInnerRadius);
+            property(o->mOuterRadius);
+            property(o->mInnerRoundness);
+            property(o->mOuterRoundness);
+            property(o->mRotation);
+            break;
+        }
+        case LOTData::Type::Trim: {
+            auto o = make<LOTTrimData>();
+            obj = o;
+            property(o->mStart);
+            property(o->mEnd);
+            property(o->mOffset);
+            pod(o->mTrimType, LOTTrimData::TrimType::Simultaneously, LOTTrimData::TrimType::Individually);
+            break;
+        }
+        case LOTData::Type::Repeater: {
+            auto o = make<LOTRepeaterData>();
+            obj = o;
+            LOTData *content = node();
+            if (content && content->type() != LOTData::Type::ShapeGroup) mFailed = true;
+            o->setContent(static_cast<LOTShapeGroupData *>(content));
+            property(o->mTransform.mRotation);
+            property(o->mTransform.mScale);
+            property(o->mTransform.mPosition);
+            property(o->mTransform.mAnchor);
+            property(o->mTransform.mStartOpacity);
+            property(o->mTransform.mEndOpacity);
+            property(o->mCopies);
+            property(o->mOffset);
+            pod(o->mMaxCopies);
+            pod(o->mProcessed);
+            break;
+        }
+        default:
+            mFailed = true;
+            return nullptr;
+        }
+        return mFailed ? nullptr : obj;
+    }
+
+    void composition()
+    {
+        data(mComp);
+        mComp->mVersion = str();
+        mComp->mSize.setWidth(pod<int>());
+        mComp->mSize.setHeight(pod<int>());
+        mComp->mStartFrame = long(pod<int64_t>());
+        mComp->mEndFrame = long(pod<int64_t>());
+        pod(mComp->mFrameRate);
+        pod(mComp->mBlendMode, LottieBlendMode::Normal, LottieBlendMode::OverLay);
+
+        // renderer expects precomp root layer, the parser always makes one
+        LOTData *root = node();
+        if (!root || root->type() != LOTData::Type::Layer ||
+            static_cast<LOTLayerData *>(root)->mLayerType != LayerType::Precomp) {
+            mFailed = true;
+            return;
+        }
+        mComp->mRootLayer = static_cast<LOTLayerData *>(root);
+
+        uint32_t n = count();
+        for (uint32_t i = 0; i < n && !mFailed; i++) {
+            std::string refId = str();
+            mComp->mAssets[refId] = asset();
+        }
+
+        n = count();
+        for (uint32_t i = 0; i < n && !mFailed; i++) {
+            std::string name = str();
+            const int start = pod<int32_t>();
+            const int end = pod<int32_t>();
+            mComp->mMarkers.emplace_back(std::move(name), start, end);
+        }
+
+        if (mPos != mEnd) mFailed = true;
+    }
+
+private:
+    VArenaAlloc &allocator() { return mComp->mArenaAlloc; }
+
+    enum class Kind : uint8_t { Node, Interpolator, Asset };
+
+    // object get index in same order as writer meet it first time
+    void add(void *obj, Kind kind)
+    {
+        mObjects.push_back(obj);
+        mKinds.push_back(kind);
+    }
+
+    template <typename T>
+    T *make()
+    {
+        T *obj = allocator().make<T>();
+        add(static_cast<LOTData *>(obj), Kind::Node);
+        data(obj);
+        return obj;
+    }
+
+    void data(LOTData *obj)
+    {
+        obj->setName(str().c_str());
+        obj->setStatic(pod<bool>());
+        obj->setHidden(pod<bool>());
+    }
+
+    // resolve reference to already read object, returns false when new object follow
+    template <typename T>
+    bool ref(T *&obj, Kind kind)
+    {
+        switch (pod<uint8_t>()) {
+        case LOTB_NULL:
+            obj = nullptr;
+            return true;
+        case LOTB_REF: {
+            const uint32_t index = pod<uint32_t>();
+            if (index >= mObjects.size() || mKinds[index] != kind) {
+                mFailed = true;
+                obj = nullptr;
+            } else {
+                obj = static_cast<T *>(mObjects[index]);
+            }
+            return true;
+        }
+        case LOTB_NEW:
+            if (mFailed) {
+                obj = nullptr;
+                return true;
+            }
+            return false;
+        default:
+            mFailed = true;
+            obj = nullptr;
+            return true;
+        }
+    }
+
+    const uint8_t       *mPos;
+    const uint8_t       *mEnd;
+    LOTCompositionData  *mComp;
+    std::string          mDirPath;
+    std::vector<void *>  mObjects;
+    std::vector<Kind>    mKinds;
+    int                  mDepth{0};
+    bool                 mFailed{false};
+};
+
+}  // namespace
+
+// read only view of whole file, pages are loaded on first access
+class VMappedFile {
+public:
+    explicit VMappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) return;
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mMapping) return;
+        void *data = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) return;
+        mData = static_cast<const uint8_t *>(data);
+        mSize = size_t(size.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                mData = static_cast<const uint8_t *>(data);
+                mSize = size_t(st.st_size);
+            }
+        }
+        close(fd);
+#endif
+    }
+    ~VMappedFile()
+    {
+#ifdef _WIN32
+        if (mData) UnmapViewOfFile(mData);
+        if (mMapping) CloseHandle(mMapping);
+        if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+#else
+        if (mData) munmap(const_cast<uint8_t *>(mData), mSize);
+#endif
+    }
+    VMappedFile(const VMappedFile &) = delete;
+    VMappedFile &operator=(const VMappedFile &) = delete;
+
+    const uint8_t *data() const { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+#ifdef _WIN32
+    HANDLE         mFile{INVALID_HANDLE_VALUE};
+    HANDLE         mMapping{nullptr};
+#endif
+    const uint8_t *mData{nullptr};
+    size_t         mSize{0};
+};
+
+// whole file by one sized read, content keep its capacity when it is reused
+static bool readSource(const std::string &path, std::string &content)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
 
-    for (const auto &elm : mData)
-        result.push_back(elm.value(frameNo));
+    const std::streamoff size = file.tellg();
+    if (size <= 0)
+        return false;
 
-    // if the size is even then we are missing last
-    // gap information which is same as the last dash value
-    // copy it from the last dash value.
-    // NOTE: last value is the offset and last-1 is the last dash value.
-    auto size = result.size();
-    if ((size % 2) == 0) {
-        //copy offset value to end.
-        result.push_back(result.back());
-        // copy dash value to gap.
-        result[size-1] = result[size-2];
-    }
+    content.resize(size_t(size));
+    file.seekg(0);
+    return bool(file.read(&content[0], size));
 }
 
-/**
-* Both the color stops and opacity stops are in the same array.
-* There are {@link #colorPoints} colors sequentially as:
-* [
-*     ...,
-*     position,
-*     red,
-*     green,
-*     blue,
-*     ...
-* ]
-*
-* The remainder of the array is the opacity stops sequentially as:
-* [
-*     ...,
-*     position,
-*     opacity,
-*     ...
-* ]
-*/
-void LOTGradient::populate(VGradientStops &stops, int frameNo)
+static bool isBinaryPath(const std::string &path)
 {
-    LottieGradient gradData = mGradient.value(frameNo);
-    auto            size = gradData.mGradient.size();
-    float *        ptr = gradData.mGradient.data();
-    int            colorPoints = mColorPoints;
-    if (colorPoints == -1) {  // for legacy bodymovin (ref: lottie-android)
-        colorPoints = int(size / 4);
-    }
-    auto    opacityArraySize = size - colorPoints * 4;
-    float *opacityPtr = ptr + (colorPoints * 4);
-    stops.clear();
-    size_t j = 0;
-    for (int i = 0; i < colorPoints; i++) {
-        float       colorStop = ptr[0];
-        LottieColor color = LottieColor(ptr[1], ptr[2], ptr[3]);
-        if (opacityArraySize) {
-            if (j == opacityArraySize) {
-                // already reached the end
-                float stop1 = opacityPtr[j - 4];
-                float op1 = opacityPtr[j - 3];
-                float stop2 = opacityPtr[j - 2];
-                float op2 = opacityPtr[j - 1];
-                if (colorStop > stop2) {
-                    stops.push_back(
-                        std::make_pair(colorStop, color.toColor(op2)));
+    return path.size() > 5 && path.compare(path.size() - 5, 5, ".lotb") == 0;
+}
+
+namespace {
+
+// walks json by chunks and picks numbers of wanted keys of top level object,
+// strings and nested objects/arrays are only skipped
+class LottieInfoScanner {
+public:
+    // returns true when scan is finished, found or not
+    bool feed(const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size && !mDone; i++) {
+            const char c = data[i];
+            if (mInString) {
+                string(c);
+            } else if (mNumber) {
+                if (isNumberChar(c)) {
+                    appendNumber(c);
                 } else {
-                    float progress = (colorStop - stop1) / (stop2 - stop1);
-                    float opacity = op1 + progress * (op2 - op1);
-                    stops.push_back(
-                        std::make_pair(colorStop, color.toColor(opacity)));
+                    finishNumber();
+                    structural(c);
                 }
-                continue;
+            } else {
+                structural(c);
             }
-            for (; j < opacityArraySize; j += 2) {
-                float opacityStop = opacityPtr[j];
-                if (opacityStop < colorStop) {
-                    // add a color using opacity stop
-                    stops.push_back(std::make_pair(
-                        opacityStop, color.toColor(opacityPtr[j + 1])));
-                    continue;
-                }
-                // add a color using color stop
-                if (j == 0) {
-                    stops.push_back(std::make_pair(
-                        colorStop, color.toColor(opacityPtr[j + 1])));
-                } else {
-                    float progress = (colorStop - opacityPtr[j - 2]) /
-                        (opacityPtr[j] - opacityPtr[j - 2]);
-                    float opacity =
-                        opacityPtr[j - 1] +
-                        progress * (opacityPtr[j + 1] - opacityPtr[j - 1]);
-                    stops.push_back(
-                        std::make_pair(colorStop, color.toColor(opacity)));
-                }
-                j += 2;
-                break;
+        }
+        return mDone;
+    }
+
+    bool result(LOTCompositionInfo &info)
+    {
+        if (mNumber) finishNumber();
+        if (mFound != ALL) return false;
+        info = mInfo;
+        return true;
+    }
+
+private:
+    enum Key { NONE = 0, FR = 1, IP = 2, OP = 4, W = 8, H = 16, ALL = 31 };
+
+    static bool isNumberChar(char c)
+    {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+               c == 'e' || c == 'E';
+    }
+
+    void string(char c)
+    {
+        if (mEscape) {
+            mEscape = false;
+        } else if (c == '\\') {
+            mEscape = true;
+        } else if (c == '"') {
+            mInString = false;
+        }
+        if (mKeyString) {
+            if (mInString) {
+                if (mKeyLength < sizeof(mKey) - 1) mKey[mKeyLength] = c;
+                mKeyLength++;
+            } else {
+                mKeyString = false;
+                mExpectKey = false;
+                mLastKey = keyOf();
             }
-        } else {
-            stops.push_back(std::make_pair(colorStop, color.toColor()));
         }
-        ptr += 4;
     }
-}
 
-void LOTGradient::update(std::unique_ptr<VGradient> &grad, int frameNo)
-{
-    bool init = false;
-    if (!grad) {
-        if (mGradientType == 1)
-            grad = std::make_unique<VGradient>(VGradient::Type::Linear);
-        else
-            grad = std::make_unique<VGradient>(VGradient::Type::Radial);
-        grad->mSpread = VGradient::Spread::Pad;
-        init = true;
+    Key keyOf() const
+    {
+        if (mKeyLength >= sizeof(mKey) - 1) return NONE;
+        const std::string key(mKey, mKeyLength);
+        if (key == "fr") return FR;
+        if (key == "ip") return IP;
+        if (key == "op") return OP;
+        if (key == "w") return W;
+        if (key == "h") return H;
+        return NONE;
     }
 
-    if (!mGradient.isStatic() || init) {
-        populate(grad->mStops, frameNo);
+    void structural(char c)
+    {
+        switch (c) {
+        case '"':
+            mInString = true;
+            mKeyString = mDepth == 1 && mExpectKey;
+            mKeyLength = 0;
+            mValueKey = NONE;
+            break;
+        case '{':
+        case '[':
+            mValueKey = NONE;
+            if (++mDepth == 1) mExpectKey = c == '{';
+            if (mDepth == 1 && c != '{') mDone = true;
+            break;
+        case '}':
+        case ']':
+            if (--mDepth <= 0) mDone = true;
+            break;
+        case ',':
+            if (mDepth == 1) mExpectKey = true;
+            break;
+        case ':':
+            if (mDepth == 1) mValueKey = mLastKey;
+            break;
+        default:
+            if (mDepth == 1 && mValueKey != NONE && isNumberChar(c)) {
+                mNumber = true;
+                mNumberLength = 0;
+                appendNumber(c);
+            } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                // true, false or null value
+                mValueKey = NONE;
+            }
+            break;
+        }
     }
 
-    if (mGradientType == 1) {  // linear gradient
-        VPointF start = mStartPoint.value(frameNo);
-        VPointF end = mEndPoint.value(frameNo);
-        grad->linear.x1 = start.x();
-        grad->linear.y1 = start.y();
-        grad->linear.x2 = end.x();
-        grad->linear.y2 = end.y();
-    } else {  // radial gradient
-        VPointF start = mStartPoint.value(frameNo);
-        VPointF end = mEndPoint.value(frameNo);
-        grad->radial.cx = start.x();
-        grad->radial.cy = start.y();
-        grad->radial.cradius =
-            VLine::length(start.x(), start.y(), end.x(), end.y());
-        /*
-        * Focal point is the point lives in highlight length distance from
-        * center along the line (start, end)  and rotated by highlight angle.
-        * below calculation first finds the quadrant(angle) on which the point
-        * lives by applying inverse slope formula then adds the rotation angle
-        * to find the final angle. then point is retrived using circle equation
-        * of center, angle and distance.
-        */
-        float progress = mHighlightLength.value(frameNo) / 100.0f;
-        if (vCompare(progress, 1.0f)) progress = 0.99f;
-        float startAngle = VLine(start, end).angle();
-        float highlightAngle = mHighlightAngle.value(frameNo);
-        static constexpr float K_PI = 3.1415926f;
-        float angle = (startAngle + highlightAngle) * (K_PI / 180.0f);
-        grad->radial.fx =
-            grad->radial.cx + std::cos(angle) * progress * grad->radial.cradius;
-        grad->radial.fy =
-            grad->radial.cy + std::sin(angle) * progress * grad->radial.cradius;
-        // Lottie dosen't have any focal radius concept.
-        grad->radial.fradius = 0;
+    void appendNumber(char c)
+    {
+        if (mNumberLength < sizeof(mNumberText) - 1) mNumberText[mNumberLength++] = c;
     }
-}
 
-void LOTAsset::loadImageData(std::string data)
+    void finishNumber()
+    {
+        mNumber = false;
+        mNumberText[mNumberLength] = 0;
+        char *end = nullptr;
+        const double value = strtod(mNumberText, &end);
+        if (end == mNumberText) return;
+
+        switch (mValueKey) {
+        case FR: mInfo.frameRate = float(value); break;
+        case IP: mInfo.startFrame = long(value); break;
+        case OP: mInfo.endFrame = long(value); break;
+        case W: mInfo.size.setWidth(int(value)); break;
+        case H: mInfo.size.setHeight(int(value)); break;
+        default: return;
+        }
+        mFound |= mValueKey;
+        mValueKey = NONE;
+        if (mFound == ALL) mDone = true;
+    }
+
+    LOTCompositionInfo mInfo;
+    int    mDepth{0};
+    int    mFound{NONE};
+    Key    mLastKey{NONE};
+    Key    mValueKey{NONE};
+    bool   mDone{false};
+    bool   mExpectKey{false};
+    bool   mInString{false};
+    bool   mKeyString{false};
+    bool   mEscape{false};
+    bool   mNumber{false};
+    char   mKey[8];
+    size_t mKeyLength{0};
+    char   mNumberText[32];
+    size_t mNumberLength{0};
+};
+
+} // namespace
+
+bool LottieLoader::scanInfo(const std::string &path, LOTCompositionInfo &info)
 {
-    if (!data.empty())
-        mBitmap = VImageLoader::instance().load(data.c_str(), data.length());
+    if (isBinaryPath(path)) return false;
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) return false;
+
+    LottieInfoScanner scanner;
+    char chunk[4096];
+    while (file) {
+        file.read(chunk, sizeof(chunk));
+        if (scanner.feed(chunk, size_t(file.gcount()))) break;
+    }
+    return scanner.result(info);
 }
 
-void LOTAsset::loadImagePath(std::string path)
+std::string LottieLoader::binaryPath(const std::string &path)
 {
-    if (!path.empty()) mBitmap = VImageLoader::instance().load(path.c_str());
+    const size_t slash = path.find_last_of("/\\");
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + ".lotb";
+    return path.substr(0, dot) + ".lotb";
 }
 
-std::vector<LayerInfo> LOTCompositionData::layerInfoList() const
+bool LottieLoader::convertToBinary(const std::string &path, const std::string &binaryPath)
 {
-    if (!mRootLayer || mRootLayer->mChildren.empty()) return {};
+    std::string content;
+    if (!readSource(path, content)) return false;
 
-    std::vector<LayerInfo> result;
+    const uint64_t sourceHash = lotbSourceHash(content.data(), content.size());
+    LottieParser parser(const_cast<char *>(content.c_str()), dirname(path).c_str());
+    auto model = parser.model();
+    if (!model) return false;
 
-    result.reserve(mRootLayer->mChildren.size());
+    LotbWriter writer(dirname(path));
+    writer.composition(model->mRoot.get());
 
-    for (auto it : mRootLayer->mChildren) {
-        auto layer = static_cast<LOTLayerData *>(it);
-        result.emplace_back(layer->name(), layer->mInFrame, layer->mOutFrame);
-    }
+    LotbHeader header{};
+    memcpy(header.magic, LOTB_MAGIC, sizeof(header.magic));
+    header.version = LOTB_VERSION;
+    header.byteOrder = LOTB_BYTE_ORDER;
+    header.sourceHash = sourceHash;
+    header.payloadSize = writer.mData.size();
 
-    return result;
+    std::ofstream file(binaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(writer.mData.data()), std::streamsize(writer.mData.size()));
+    return bool(file);
 }
 
-class LottieModelCache {
-public:
-    static LottieModelCache &instance()
-    {
-        static LottieModelCache CACHE;
-        return CACHE;
-    }
-    std::shared_ptr<LOTModel> find(const std::string &) { return nullptr; }
-    void add(const std::string &, std::shared_ptr<LOTModel>) {}
-    void configureCacheSize(size_t) {}
-};
-
-void LottieLoader::configureModelCacheSize(size_t cacheSize)
+// source is json which blob was made from, when it given blob is used only if hash match
+bool LottieLoader::loadBinary(const std::string &binaryPath, const std::string *source)
 {
-    LottieModelCache::instance().configureCacheSize(cacheSize);
-}
+    VMappedFile file(binaryPath);
+    if (file.size() < sizeof(LotbHeader)) return false;
 
-static std::string dirname(const std::string &path)
-{
-    const char *ptr = strrchr(path.c_str(), '/');
-#ifdef _WIN32
-    if (ptr) ptr = strrchr(ptr + 1, '\\');
-#endif
-    int         len = int(ptr + 1 - path.c_str());  // +1 to include '/'
-    return std::string(path, 0, len);
-}
+    LotbHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, LOTB_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LOTB_VERSION || header.byteOrder != LOTB_BYTE_ORDER ||
+        header.payloadSize != file.size() - sizeof(header))
+        return false;
+
+    if (source && header.sourceHash != lotbSourceHash(source->data(), source->size()))
+        return false;
+
+    auto composition = std::make_shared<LOTCompositionData>();
+    LotbReader reader(file.data() + sizeof(header), size_t(header.payloadSize),
+                      composition.get(), dirname(binaryPath));
+    reader.composition();
+    if (reader.failed()) return false;
 
+    composition->updateStats();
+    composition->mStats.sourceBytes = size_t(header.payloadSize);
+
+    mModel = std::make_shared<LOTModel>();
+    mModel->mRoot = std::move(composition);
+    return true;
+}
 
 bool LottieLoader::load(const std::string &path, bool cachePolicy)
 {
+    std::string cacheKey;
     if (cachePolicy) {
-        mModel = LottieModelCache::instance().find(path);
+        cacheKey = fileCacheKey(path);
+        mModel = LottieModelCache::instance().find(cacheKey);
         if (mModel) return true;
     }
 
-    FILE* f = std::fopen(path.c_str(), "r");
-
-    std::ifstream file(path, std::ios::in | std::ios::binary);
-    if (!file.is_open())
-        return { };
+    if (isBinaryPath(path)) {
+        if (!loadBinary(path, nullptr)) return false;
+    } else {
+        // source buffer is pooled per thread, in-situ parser only need it while
+        // parsing. Buffer of unusually big file is not kept
+        static constexpr size_t MAX_POOLED_SOURCE = 4 * 1024 * 1024;
+        static thread_local std::string content;
+        struct TrimSource {
+            ~TrimSource() { if (content.capacity() > MAX_POOLED_SOURCE) std::string().swap(content); }
+        } trimSource;
+        if (!readSource(path, content)) return false;
 
-    // Read contents
-    std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        // precompiled model is used while it made from same json
+        if (!loadBinary(binaryPath(path), &content)) {
+            const char *str = content.c_str();
+            LottieParser parser(const_cast<char *>(str),
+                                dirname(path).c_str());
+            mModel = parser.model();
 
-    // Close the file
-    file.close();
+            if (!mModel) return false;
 
-    if (content.empty()) {
-        return false;
+            mModel->mRoot->mStats.sourceBytes = content.size();
+        }
     }
 
-    const char *str = content.c_str();
-    LottieParser parser(const_cast<char *>(str),
-                        dirname(path).c_str());
-    mModel = parser.model();
-
-    if (!mModel) return false;
-
     if (cachePolicy) {
-        LottieModelCache::instance().add(path, mModel);
+        LottieModelCache::instance().add(cacheKey, mModel);
     }
 
     return true;
@@ -5967,19 +8645,28 @@ bool LottieLoader::load(const std::string &path, bool cachePolicy)
 bool LottieLoader::loadFromData(std::string &&jsonData, const std::string &key,
                                 const std::string &resourcePath, bool cachePolicy)
 {
+    // data without key cached by content, parser modify json in place so hash it before
+    std::string cacheKey = key;
+    if (cachePolicy && cacheKey.empty()) {
+        cacheKey = dataKey("data:", jsonData) + "|" + resourcePath;
+    }
+
     if (cachePolicy) {
-        mModel = LottieModelCache::instance().find(key);
+        mModel = LottieModelCache::instance().find(cacheKey);
         if (mModel) return true;
     }
 
+    const size_t sourceBytes = jsonData.size();
     LottieParser parser(const_cast<char *>(jsonData.c_str()),
                         resourcePath.c_str());
     mModel = parser.model();
 
     if (!mModel) return false;
 
+    mModel->mRoot->mStats.sourceBytes = sourceBytes;
+
     if (cachePolicy)
-        LottieModelCache::instance().add(key, mModel);
+        LottieModelCache::instance().add(cacheKey, mModel);
 
     return true;
 }
@@ -6730,7 +9417,6 @@ LOTImageLayerItem::LOTImageLayerItem(LOTLayerData *layerData)
 
     if (!mLayerData->asset()) return;
 
-    mTexture.mBitmap = mLayerData->asset()->bitmap();
     VBrush brush(&mTexture);
     mRenderNode.setBrush(brush);
 }
@@ -6739,6 +9425,9 @@ void LOTImageLayerItem::updateContent()
 {
     if (!mLayerData->asset()) return;
 
+    // image is decoded when layer is shown first time
+    if (!mTexture.mBitmap.valid()) mTexture.mBitmap = mLayerData->asset()->bitmap();
+
     if (flag() & DirtyFlagBit::Matrix) {
         VPath path;
         path.addRect(VRectF(0, 0, mLayerData->asset()->mWidth,
@@ -7853,47 +10542,57 @@ using SharedRenderTask = std::shared_ptr<RenderTask>;
 class AnimationImpl {
 public:
     void    init(const std::shared_ptr<LOTModel> &model);
+    void    initLazy(const std::string &filePath, bool cachePolicy, const LOTCompositionInfo &info);
+    bool    load();
     bool    update(size_t frameNo, const VSize &size, bool keepAspectRatio);
-    VSize   size() const { return mModel->size(); }
-    double  duration() const { return mModel->duration(); }
-    double  frameRate() const { return mModel->frameRate(); }
-    size_t  totalFrame() const { return mModel->totalFrame(); }
-    size_t  frameAtPos(double pos) const { return mModel->frameAtPos(pos); }
+    VSize   size() const { return mInfo.size; }
+    double  duration() const { return mInfo.duration(); }
+    double  frameRate() const { return mInfo.frameRate; }
+    size_t  totalFrame() const { return mInfo.totalFrame(); }
+    size_t  frameAtPos(double pos) const { return mInfo.frameAtPos(pos); }
     Surface render(size_t frameNo, const Surface &surface, bool keepAspectRatio);
 
     const LOTLayerNode * renderTree(size_t frameNo, const VSize &size);
 
-    const LayerInfoList &layerInfoList() const
+    const LayerInfoList &layerInfoList()
     {
-        if (mLayerList.empty()) {
+        if (mLayerList.empty() && load()) {
             mLayerList = mModel->layerInfoList();
         }
         return mLayerList;
     }
-    const MarkerList &markers() const
+    const MarkerList &markers()
     {
-        return mModel->markers();
+        static const MarkerList empty;
+        return load() ? mModel->markers() : empty;
     }
     void setValue(const std::string &keypath, LOTVariant &&value);
     void removeFilter(const std::string &keypath, Property prop);
 
 private:
+    void    setModel(const std::shared_ptr<LOTModel> &model);
+
     mutable LayerInfoList        mLayerList;
     std::string                  mFilePath;
+    bool                         mCachePolicy{true};
+    // header of composition, known before model when animation is loaded lazy
+    LOTCompositionInfo           mInfo;
+    std::once_flag               mLoadOnce;
     std::shared_ptr<LOTModel>    mModel;
     std::unique_ptr<LOTCompItem> mCompItem;
     SharedRenderTask             mTask;
-    std::atomic<bool>            mRenderInProgress;
+    std::atomic<bool>            mRenderInProgress{false};
 };
 
 void AnimationImpl::setValue(const std::string &keypath, LOTVariant &&value)
 {
-    if (keypath.empty()) return;
+    if (keypath.empty() || !load()) return;
     mCompItem->setValue(keypath, value);
 }
 
 const LOTLayerNode *AnimationImpl::renderTree(size_t frameNo, const VSize &size)
 {
+    if (!load()) return nullptr;
     if (update(frameNo, size, true)) {
         mCompItem->buildRenderTree();
     }
@@ -7919,6 +10618,8 @@ Surface AnimationImpl::render(size_t frameNo, const Surface &surface, bool keepA
         return surface;
     }
 
+    if (!load()) return surface;
+
     mRenderInProgress.store(true);
     update(frameNo,
            VSize(int(surface.drawRegionWidth()), int(surface.drawRegionHeight())), keepAspectRatio);
@@ -7929,10 +10630,41 @@ Surface AnimationImpl::render(size_t frameNo, const Surface &surface, bool keepA
 }
 
 void AnimationImpl::init(const std::shared_ptr<LOTModel> &model)
+{
+    std::call_once(mLoadOnce, [&] { setModel(model); });
+}
+
+void AnimationImpl::initLazy(const std::string &filePath, bool cachePolicy,
+                             const LOTCompositionInfo &info)
+{
+    mFilePath = filePath;
+    mCachePolicy = cachePolicy;
+    mInfo = info;
+}
+
+// model of lazy animation is parsed once by thread which need it first,
+// others wait for it
+bool AnimationImpl::load()
+{
+    std::call_once(mLoadOnce, [this] {
+        LottieLoader loader;
+        if (loader.load(mFilePath, mCachePolicy)) {
+            setModel(loader.model());
+        } else {
+            vWarning << "Lazy loaded animation can't be parsed " << mFilePath;
+        }
+    });
+    return mCompItem != nullptr;
+}
+
+void AnimationImpl::setModel(const std::shared_ptr<LOTModel> &model)
 {
     mModel = model;
+    mInfo.size = model->size();
+    mInfo.startFrame = long(model->startFrame());
+    mInfo.endFrame = long(model->endFrame());
+    mInfo.frameRate = float(model->frameRate());
     mCompItem = std::make_unique<LOTCompItem>(mModel.get());
-    mRenderInProgress = false;
 }
 
 class RenderTaskScheduler {
@@ -7991,6 +10723,23 @@ std::shared_ptr<Animation> Animation::loadFromFile(const std::string &path, bool
     return nullptr;
 }
 
+std::shared_ptr<Animation> Animation::loadFromFileLazy(const std::string &path, bool cachePolicy)
+{
+    LOTCompositionInfo info;
+    if (path.empty() || !LottieLoader::scanInfo(path, info)) {
+        return loadFromFile(path, cachePolicy);
+    }
+
+    auto animation = std::make_shared<Animation>();
+    animation->d->initLazy(path, cachePolicy, info);
+    return animation;
+}
+
+bool Animation::load()
+{
+    return d->load();
+}
+
 void Animation::size(size_t &width, size_t &height) const
 {
     VSize sz = d->size();
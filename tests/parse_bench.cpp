@@ -0,0 +1,86 @@
+// Benchmark of json parse throughput, parses every animation of test/ from
+// memory a few rounds and prints MB/s of best round per file and in total.
+// By default one parser thread is measured, with parse threads other than 1
+// files of at least 64 KB are parsed in parallel, 0 means hardware concurrency.
+//
+// usage: parse_bench <dir with json files> [rounds] [parse threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "imlottie_impl.h"
+
+struct Source {
+    std::string name;
+    std::string dir;
+    std::string json;
+};
+
+// milliseconds to parse source, parser modifies json in place so copy is parsed
+static double parse(const Source &source, bool &ok)
+{
+    std::string json = source.json;
+    const auto start = std::chrono::steady_clock::now();
+    imlottie::LottieLoader loader;
+    ok = loader.loadFromData(std::move(json), "", source.dir, false);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s dir [rounds] [parse threads]\n", argv[0]);
+        return 1;
+    }
+
+    const int rounds = argc > 2 ? std::max(1, atoi(argv[2])) : 20;
+    const int threads = argc > 3 ? std::max(0, atoi(argv[3])) : 1;
+
+    std::vector<Source> sources;
+    for (auto &entry : std::filesystem::directory_iterator(argv[1])) {
+        if (entry.path().extension() != ".json")
+            continue;
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        sources.push_back({entry.path().filename().string(), entry.path().parent_path().string(), content.str()});
+    }
+    if (sources.empty()) {
+        printf("no json files in <%s>\n", argv[1]);
+        return 1;
+    }
+    std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b) { return a.name < b.name; });
+
+    imlottie::LottieLoader::configureParallelParse(
+        threads == 1 ? std::numeric_limits<size_t>::max() : 64 * 1024, unsigned(threads));
+
+    printf("%zu files, best of %d rounds, %d parse threads\n", sources.size(), rounds, threads);
+    printf("%-20s %10s %10s %8s\n", "file", "bytes", "ms", "MB/s");
+    double totalMs = 0;
+    size_t totalBytes = 0;
+    for (auto &source : sources) {
+        bool ok = false;
+        double best = parse(source, ok);
+        if (!ok) {
+            printf("failed to parse <%s>\n", source.name.c_str());
+            return 1;
+        }
+        for (int round = 1; round < rounds; ++round) {
+            best = std::min(best, parse(source, ok));
+        }
+        printf("%-20s %10zu %10.3f %8.1f\n", source.name.c_str(), source.json.size(), best,
+               source.json.size() / best / 1000.0);
+        totalMs += best;
+        totalBytes += source.json.size();
+    }
+    printf("%-20s %10zu %10.3f %8.1f\n", "all", totalBytes, totalMs, totalBytes / totalMs / 1000.0);
+    return 0;
+}
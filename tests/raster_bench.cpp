@@ -0,0 +1,63 @@
+// Benchmark of gray raster passes, renders every frame of one animation and
+// prints time of best round and raster counters of one round. Bands beyond
+// one per outline decompose outline again, with growable cell pool large
+// frames should be rasterized in one pass.
+//
+// usage: raster_bench <json file> [size] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "imlottie_impl.h"
+
+static double renderAll(imlottie::Animation &anim, int size)
+{
+    std::vector<uint32_t> buffer(size * size);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < anim.totalFrame(); ++frame) {
+        anim.renderSync(frame, imlottie::Surface(buffer.data(), size, size, size * 4));
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s file [size] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    const int size = argc > 2 ? std::max(1, atoi(argv[2])) : 512;
+    const int rounds = argc > 3 ? std::max(1, atoi(argv[3])) : 3;
+
+    auto anim = imlottie::Animation::loadFromFile(argv[1], false);
+    if (!anim) {
+        printf("failed to load <%s>\n", argv[1]);
+        return 1;
+    }
+
+    // first round also grows cell pool, its counters are what a cold thread pays
+    imlottie::LottieLoader::rasterStats(true);
+    double best = renderAll(*anim, size);
+    const auto first = imlottie::LottieLoader::rasterStats(true);
+    for (int round = 1; round < rounds; ++round) {
+        best = std::min(best, renderAll(*anim, size));
+    }
+    const auto last = imlottie::LottieLoader::rasterStats(true);
+
+    printf("%s, %zu frames at %dpx, best of %d rounds %.1f ms\n", argv[1], anim->totalFrame(), size, rounds, best);
+    printf("%-6s %10s %10s %10s %10s %10s\n", "round", "outlines", "bands", "re-bands", "splits", "grows");
+    printf("%-6s %10zu %10zu %10zu %10zu %10zu\n", "first", first.outlines, first.bands,
+           first.bands - first.outlines, first.bandSplits, first.poolGrows);
+    if (rounds > 1) {
+        printf("%-6s %10zu %10zu %10zu %10zu %10zu\n", "other", last.outlines / (rounds - 1),
+               last.bands / (rounds - 1), (last.bands - last.outlines) / (rounds - 1),
+               last.bandSplits / (rounds - 1), last.poolGrows);
+    }
+    printf("cell pools hold %zu bytes\n", last.poolBytes);
+    return 0;
+}
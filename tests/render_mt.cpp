@@ -0,0 +1,155 @@
+// Renders every animation of test/ from many threads at same time and checks
+// that frames are equal to frames rendered by single thread, so renderer has
+// no shared state which breaks when animations are rendered in parallel.
+// Second pass loads animations through model cache, like animationLoad(), and
+// all threads render same files together, so every model is rendered from
+// many threads at once.
+// With more than one raster thread paths are rasterized on the raster pool,
+// checksums are then compared with ones saved by run with one raster thread.
+//
+// usage: render_mt <dir with json files> [threads] [raster threads] [checksums file]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "imlottie_impl.h"
+
+static const int FRAME_SIZE = 64;
+
+// checksum of all frames of animation, 0 when it was not loaded. Without
+// cache every call parses own model, with cache it gets model of the file
+// which is already loaded and builds only own render tree
+static uint64_t renderChecksum(const std::string &path, bool cachePolicy)
+{
+    auto anim = cachePolicy ? imlottie::Animation::loadFromFileLazy(path, true)
+                            : imlottie::Animation::loadFromFile(path, false);
+    if (!anim) {
+        return 0;
+    }
+
+    std::vector<uint32_t> buffer(FRAME_SIZE * FRAME_SIZE);
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t frame = 0; frame < anim->totalFrame(); ++frame) {
+        std::fill(buffer.begin(), buffer.end(), 0);
+        anim->renderSync(frame, imlottie::Surface(buffer.data(), FRAME_SIZE, FRAME_SIZE, FRAME_SIZE * 4));
+        for (uint32_t pixel : buffer) {
+            hash = (hash ^ pixel) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s dir [threads] [raster threads] [checksums file]\n", argv[0]);
+        return 1;
+    }
+
+    const int threadsNum = argc > 2 ? atoi(argv[2]) : 8;
+    const int rasterThreadsNum = argc > 3 ? atoi(argv[3]) : 1;
+    const char *checksumsPath = argc > 4 ? argv[4] : nullptr;
+    imlottie::LottieLoader::configureRasterThreads(rasterThreadsNum);
+
+    std::vector<std::string> files;
+    for (auto &entry : std::filesystem::directory_iterator(argv[1])) {
+        if (entry.path().extension() == ".json") {
+            files.push_back(entry.path().string());
+        }
+    }
+    if (files.empty()) {
+        printf("no json files in <%s>\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint64_t> expected(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        expected[i] = renderChecksum(files[i], false);
+        if (expected[i] == 0) {
+            printf("failed to load <%s>\n", files[i].c_str());
+            return 1;
+        }
+    }
+
+    // checksums of one raster thread are reference for raster pool
+    if (checksumsPath && rasterThreadsNum == 1) {
+        std::ofstream out(checksumsPath);
+        for (size_t i = 0; i < files.size(); ++i) {
+            out << std::filesystem::path(files[i]).filename().string() << ' ' << expected[i] << '\n';
+        }
+        if (!out) {
+            printf("failed to write <%s>\n", checksumsPath);
+            return 1;
+        }
+    } else if (checksumsPath) {
+        std::map<std::string, uint64_t> reference;
+        std::ifstream in(checksumsPath);
+        std::string name;
+        uint64_t checksum;
+        while (in >> name >> checksum) {
+            reference[name] = checksum;
+        }
+        for (size_t i = 0; i < files.size(); ++i) {
+            auto found = reference.find(std::filesystem::path(files[i]).filename().string());
+            if (found == reference.end()) {
+                printf("no reference checksum of <%s> in <%s>\n", files[i].c_str(), checksumsPath);
+                return 1;
+            }
+            if (found->second != expected[i]) {
+                printf("frames of <%s> differ from one raster thread\n", files[i].c_str());
+                return 1;
+            }
+        }
+    }
+
+    // threads start from different files, so same and different animations are rendered together
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsNum; ++t) {
+        threads.emplace_back([&, t] () {
+            for (size_t k = 0; k < files.size(); ++k) {
+                const size_t i = (k + t * 3) % files.size();
+                if (renderChecksum(files[i], false) != expected[i]) {
+                    printf("thread %d: frames of <%s> differ\n", t, files[i].c_str());
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // models are loaded and kept alive here but not rendered, so lazily
+    // decoded images and keyframe cursors are first used by all threads at once
+    std::vector<std::shared_ptr<imlottie::Animation>> models;
+    for (auto &file : files) {
+        models.push_back(imlottie::Animation::loadFromFile(file, true));
+    }
+    std::atomic<int> sharedMismatches{0};
+    threads.clear();
+    for (int t = 0; t < threadsNum; ++t) {
+        threads.emplace_back([&, t] () {
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (renderChecksum(files[i], true) != expected[i]) {
+                    printf("thread %d: frames of shared model of <%s> differ\n", t, files[i].c_str());
+                    sharedMismatches++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    printf("%zu files, %d threads, %d raster threads, %d mismatches, %d shared model mismatches\n",
+           files.size(), threadsNum, rasterThreadsNum, mismatches.load(), sharedMismatches.load());
+    return mismatches.load() == 0 && sharedMismatches.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Benchmark of per-frame update of animations of test/, frames are updated in
+// playback order, where last found keyframe usually matches, and in shuffled
+// order like seeking, where keyframes are searched. Render tree is built but
+// nothing is rasterized, so only update of model values is measured.
+//
+// usage: update_bench <dir with json files> [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "imlottie_impl.h"
+
+static const int FRAME_SIZE = 256;
+
+struct Bench {
+    std::string                          name;
+    std::shared_ptr<imlottie::Animation> anim;
+    std::vector<size_t>                  playback;
+    std::vector<size_t>                  shuffled;
+};
+
+static double updateFrames(const Bench &bench, const std::vector<size_t> &frames)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t frame : frames) {
+        bench.anim->renderTree(frame, FRAME_SIZE, FRAME_SIZE);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double bestOf(const Bench &bench, const std::vector<size_t> &frames, int rounds)
+{
+    // first update also builds render tree of animation
+    updateFrames(bench, frames);
+    double best = updateFrames(bench, frames);
+    for (int round = 1; round < rounds; ++round) {
+        best = std::min(best, updateFrames(bench, frames));
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s dir [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    const int rounds = argc > 2 ? std::max(1, atoi(argv[2])) : 5;
+
+    std::vector<Bench> benches;
+    std::mt19937 random(1);
+    for (auto &entry : std::filesystem::directory_iterator(argv[1])) {
+        if (entry.path().extension() != ".json")
+            continue;
+        auto anim = imlottie::Animation::loadFromFile(entry.path().string(), false);
+        if (!anim || !anim->totalFrame())
+            continue;
+        Bench bench{entry.path().filename().string(), anim, {}, {}};
+        for (size_t frame = 0; frame < anim->totalFrame(); ++frame) {
+            bench.playback.push_back(frame);
+        }
+        bench.shuffled = bench.playback;
+        std::shuffle(bench.shuffled.begin(), bench.shuffled.end(), random);
+        benches.push_back(std::move(bench));
+    }
+    if (benches.empty()) {
+        printf("no animations in <%s>\n", argv[1]);
+        return 1;
+    }
+    std::sort(benches.begin(), benches.end(), [](const Bench &a, const Bench &b) { return a.name < b.name; });
+
+    printf("%zu animations, best of %d rounds, us per frame\n", benches.size(), rounds);
+    printf("%-20s %6s %10s %10s\n", "file", "frames", "playback", "shuffled");
+    double total[2] = {0, 0};
+    size_t frames = 0;
+    for (auto &bench : benches) {
+        const double playback = bestOf(bench, bench.playback, rounds);
+        const double shuffled = bestOf(bench, bench.shuffled, rounds);
+        const size_t count = bench.playback.size();
+        printf("%-20s %6zu %10.2f %10.2f\n", bench.name.c_str(), count, playback / count, shuffled / count);
+        total[0] += playback;
+        total[1] += shuffled;
+        frames += count;
+    }
+    printf("%-20s %6zu %10.2f %10.2f\n", "all", frames, total[0] / frames, total[1] / frames);
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Converts lottie json files to precompiled models (.lotb), which are placed
+// near json and loaded instead of it while json is not changed.
+//
+// usage: lottie2lotb file.json [file2.json ...]
+//        lottie2lotb -o out.lotb file.json
+//
+// Image files are looked up relative to the .lotb file, as they are relative
+// to json, so out.lotb is placed where referenced images can be found.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "imlottie_impl.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: %s file.json [file2.json ...]\n", argv[0]);
+        printf("       %s -o out.lotb file.json\n", argv[0]);
+        return 1;
+    }
+
+    if (0 == strcmp(argv[1], "-o")) {
+        if (argc != 4) {
+            printf("-o expects output and one input file\n");
+            return 1;
+        }
+        if (!imlottie::LottieLoader::convertToBinary(argv[3], argv[2])) {
+            printf("failed to convert <%s>\n", argv[3]);
+            return 1;
+        }
+        return 0;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string output = imlottie::LottieLoader::binaryPath(argv[i]);
+        if (imlottie::LottieLoader::convertToBinary(argv[i], output)) {
+            printf("%s -> %s\n", argv[i], output.c_str());
+        } else {
+            printf("failed to convert <%s>\n", argv[i]);
+            failed++;
+        }
+    }
+    return failed ? 1 : 0;
+}